@@ -1,9 +1,9 @@
-QT += core gui widgets sql
+QT += core gui widgets sql concurrent
 
 TARGET = YTDLPFrontend
 TEMPLATE = app
 
-SOURCES += main.cpp mainwindow.cpp
-HEADERS += mainwindow.h
+SOURCES += main.cpp mainwindow.cpp downloadqueue.cpp outputparser.cpp consoleview.cpp updatecoalescer.cpp videolistmodel.cpp titleindex.cpp uploaddateresolver.cpp channelcache.cpp helperprocesses.cpp retryscheduler.cpp processreaper.cpp downloadoptions.cpp headlessrunner.cpp urlclassifier.cpp metadataprefetcher.cpp downloadarchive.cpp formatfetcher.cpp infojsonstore.cpp workerpool.cpp ytdlpcache.cpp cookiemanager.cpp
+HEADERS += mainwindow.h downloadqueue.h outputparser.h consoleview.h updatecoalescer.h videolistmodel.h titleindex.h uploaddateresolver.h channelcache.h helperprocesses.h retryscheduler.h processreaper.h downloadoptions.h headlessrunner.h urlclassifier.h metadataprefetcher.h downloadarchive.h formatfetcher.h infojsonstore.h workerpool.h ytdlpcache.h cookiemanager.h
 
 RESOURCES += YTDLPFrontend.qrc
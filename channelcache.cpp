@@ -0,0 +1,149 @@
+#include "channelcache.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariantList>
+
+bool ChannelCache::initialize(QString *error) {
+    QSqlQuery query;
+    if (!query.exec("CREATE TABLE IF NOT EXISTS channel_listings ("
+                    "url TEXT PRIMARY KEY, "
+                    "fetched_at INTEGER, "
+                    "complete INTEGER)")
+        || !query.exec("CREATE TABLE IF NOT EXISTS channel_entries ("
+                       "listing_url TEXT, "
+                       "position INTEGER, "
+                       "video_id TEXT, "
+                       "url TEXT, "
+                       "title TEXT, "
+                       "date TEXT, "
+                       "exact_date INTEGER)")
+        || !query.exec("CREATE INDEX IF NOT EXISTS channel_entries_listing ON channel_entries (listing_url, position)")
+        || !query.exec("CREATE INDEX IF NOT EXISTS channel_entries_video ON channel_entries (video_id)")) {
+        if (error) {
+            *error = query.lastError().text();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool ChannelCache::load(const QString &listingUrl, int limit, CachedListing *listing) {
+    QSqlQuery query;
+    query.prepare("SELECT fetched_at, complete FROM channel_listings WHERE url = ?");
+    query.addBindValue(listingUrl);
+    if (!query.exec() || !query.next()) {
+        return false;
+    }
+    listing->fetchedAt = QDateTime::fromSecsSinceEpoch(query.value(0).toLongLong());
+    listing->complete = query.value(1).toBool();
+    listing->entries.clear();
+
+    QString sql = "SELECT video_id, url, title, date, exact_date FROM channel_entries WHERE listing_url = ? ORDER BY position";
+    if (limit > 0) {
+        sql += QString(" LIMIT %1").arg(limit);
+    }
+    query.prepare(sql);
+    query.addBindValue(listingUrl);
+    if (!query.exec()) {
+        return false;
+    }
+    while (query.next()) {
+        VideoEntry entry;
+        entry.id = query.value(0).toString();
+        entry.url = query.value(1).toString();
+        entry.title = query.value(2).toString();
+        entry.date = query.value(3).toString();
+        entry.exactDate = query.value(4).toBool();
+        listing->entries.append(entry);
+    }
+    return !listing->entries.isEmpty();
+}
+
+static bool insertEntries(const QString &listingUrl, const QVector<VideoEntry> &entries) {
+    if (entries.isEmpty()) {
+        return true;
+    }
+    QVariantList listingUrls, positions, ids, urls, titles, dates, exactDates;
+    for (int i = 0; i < entries.size(); ++i) {
+        const VideoEntry &entry = entries.at(i);
+        listingUrls << listingUrl;
+        positions << i;
+        ids << entry.id;
+        urls << entry.url;
+        titles << entry.title;
+        dates << entry.date;
+        exactDates << (entry.exactDate ? 1 : 0);
+    }
+    QSqlQuery query;
+    query.prepare("INSERT INTO channel_entries (listing_url, position, video_id, url, title, date, exact_date) VALUES (?, ?, ?, ?, ?, ?, ?)");
+    query.addBindValue(listingUrls);
+    query.addBindValue(positions);
+    query.addBindValue(ids);
+    query.addBindValue(urls);
+    query.addBindValue(titles);
+    query.addBindValue(dates);
+    query.addBindValue(exactDates);
+    return query.execBatch();
+}
+
+static bool touchListing(const QString &listingUrl, bool complete) {
+    QSqlQuery query;
+    query.prepare("INSERT OR REPLACE INTO channel_listings (url, fetched_at, complete) VALUES (?, ?, ?)");
+    query.addBindValue(listingUrl);
+    query.addBindValue(QDateTime::currentSecsSinceEpoch());
+    query.addBindValue(complete ? 1 : 0);
+    return query.exec();
+}
+
+bool ChannelCache::save(const QString &listingUrl, const QVector<VideoEntry> &entries, bool complete) {
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isOpen() || !db.transaction()) {
+        return false;
+    }
+    QSqlQuery query;
+    query.prepare("DELETE FROM channel_entries WHERE listing_url = ?");
+    query.addBindValue(listingUrl);
+    if (!query.exec() || !insertEntries(listingUrl, entries) || !touchListing(listingUrl, complete)) {
+        db.rollback();
+        return false;
+    }
+    return db.commit();
+}
+
+bool ChannelCache::prepend(const QString &listingUrl, const QVector<VideoEntry> &entries, int limit) {
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isOpen() || !db.transaction()) {
+        return false;
+    }
+    QSqlQuery query;
+    query.prepare("SELECT complete FROM channel_listings WHERE url = ?");
+    query.addBindValue(listingUrl);
+    bool complete = query.exec() && query.next() && query.value(0).toBool();
+    // Known entries move down to make room, the new ones take positions 0..n-1
+    query.prepare("UPDATE channel_entries SET position = position + ? WHERE listing_url = ?");
+    query.addBindValue(entries.size());
+    query.addBindValue(listingUrl);
+    if (!query.exec() || !insertEntries(listingUrl, entries) || !touchListing(listingUrl, complete)) {
+        db.rollback();
+        return false;
+    }
+    if (limit > 0) {
+        query.prepare("DELETE FROM channel_entries WHERE listing_url = ? AND position >= ?");
+        query.addBindValue(listingUrl);
+        query.addBindValue(limit);
+        if (!query.exec()) {
+            db.rollback();
+            return false;
+        }
+    }
+    return db.commit();
+}
+
+void ChannelCache::updateDate(const QString &videoId, const QString &date) {
+    QSqlQuery query;
+    query.prepare("UPDATE channel_entries SET date = ?, exact_date = 1 WHERE video_id = ?");
+    query.addBindValue(date);
+    query.addBindValue(videoId);
+    query.exec();
+}
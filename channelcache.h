@@ -0,0 +1,28 @@
+#ifndef CHANNELCACHE_H
+#define CHANNELCACHE_H
+
+#include <QString>
+#include <QVector>
+#include <QDateTime>
+#include "videolistmodel.h"
+
+struct CachedListing {
+    QVector<VideoEntry> entries;
+    QDateTime fetchedAt;
+    // true when the whole channel was listed, not just the first N
+    bool complete = false;
+};
+
+// Channel listings kept in the bookmark database (default connection),
+// newest entry first, keyed by the listed URL (channel + /videos etc).
+class ChannelCache {
+public:
+    static bool initialize(QString *error);
+    static bool load(const QString &listingUrl, int limit, CachedListing *listing);
+    static bool save(const QString &listingUrl, const QVector<VideoEntry> &entries, bool complete);
+    // With a limit, entries pushed past it are dropped (0 = keep all)
+    static bool prepend(const QString &listingUrl, const QVector<VideoEntry> &entries, int limit = 0);
+    static void updateDate(const QString &videoId, const QString &date);
+};
+
+#endif // CHANNELCACHE_H
@@ -0,0 +1,120 @@
+#include "consoleview.h"
+#include <QScrollBar>
+
+LogBuffer::LogBuffer(int capacity) {
+    lines.resize(qMax(1, capacity));
+}
+
+void LogBuffer::append(const QString &line) {
+    lines[(head + count) % lines.size()] = line;
+    if (count < lines.size()) {
+        count++;
+    } else {
+        head = (head + 1) % lines.size();
+    }
+}
+
+void LogBuffer::clear() {
+    for (QString &line : lines) {
+        line.clear();
+    }
+    head = 0;
+    count = 0;
+}
+
+void LogBuffer::setCapacity(int capacity) {
+    capacity = qMax(1, capacity);
+    if (capacity == lines.size()) {
+        return;
+    }
+    QStringList kept = lastLines(qMin(count, capacity));
+    lines = QVector<QString>(capacity);
+    head = 0;
+    count = 0;
+    for (const QString &line : kept) {
+        append(line);
+    }
+}
+
+int LogBuffer::capacity() const {
+    return lines.size();
+}
+
+int LogBuffer::size() const {
+    return count;
+}
+
+const QString &LogBuffer::at(int index) const {
+    return lines.at((head + index) % lines.size());
+}
+
+QStringList LogBuffer::lastLines(int wanted) const {
+    QStringList result;
+    wanted = qMin(wanted, count);
+    result.reserve(wanted);
+    for (int i = count - wanted; i < count; ++i) {
+        result << at(i);
+    }
+    return result;
+}
+
+ConsoleView::ConsoleView(QWidget *parent) : QPlainTextEdit(parent) {
+    setReadOnly(true);
+    setUndoRedoEnabled(false);
+    setMaximumBlockCount(buffer.capacity());
+    flushTimer.setInterval(100);
+    flushTimer.setSingleShot(true);
+    connect(&flushTimer, &QTimer::timeout, this, &ConsoleView::flushPending);
+}
+
+void ConsoleView::append(const QString &text) {
+    const QStringList newLines = text.split('\n');
+    for (const QString &line : newLines) {
+        buffer.append(line);
+    }
+    pendingLines = qMin(pendingLines + static_cast<int>(newLines.size()), buffer.capacity());
+    if (!flushTimer.isActive()) {
+        flushTimer.start();
+    }
+}
+
+void ConsoleView::clearLog() {
+    buffer.clear();
+    pendingLines = 0;
+    clear();
+}
+
+void ConsoleView::setMaxLines(int lines) {
+    buffer.setCapacity(lines);
+    pendingLines = qMin(pendingLines, buffer.capacity());
+    setMaximumBlockCount(buffer.capacity());
+}
+
+int ConsoleView::maxLines() const {
+    return buffer.capacity();
+}
+
+void ConsoleView::setFlushInterval(int milliseconds) {
+    flushTimer.setInterval(milliseconds);
+}
+
+QStringList ConsoleView::history() const {
+    return buffer.lastLines(buffer.size());
+}
+
+void ConsoleView::flushPending() {
+    if (pendingLines == 0) {
+        return;
+    }
+    // Everything on screen is older than what the buffer still holds, start over
+    if (pendingLines >= buffer.capacity()) {
+        clear();
+    }
+    QScrollBar *scrollBar = verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+    appendPlainText(buffer.lastLines(pendingLines).join('\n'));
+    pendingLines = 0;
+    if (atBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
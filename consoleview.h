@@ -0,0 +1,50 @@
+#ifndef CONSOLEVIEW_H
+#define CONSOLEVIEW_H
+
+#include <QPlainTextEdit>
+#include <QStringList>
+#include <QVector>
+#include <QTimer>
+
+// Fixed capacity ring of log lines. Appending never grows past capacity(),
+// the oldest line is overwritten instead.
+class LogBuffer {
+public:
+    explicit LogBuffer(int capacity = 10000);
+    void append(const QString &line);
+    void clear();
+    void setCapacity(int capacity);
+    int capacity() const;
+    int size() const;
+    const QString &at(int index) const;
+    QStringList lastLines(int count) const;
+
+private:
+    QVector<QString> lines;
+    int head = 0;
+    int count = 0;
+};
+
+// Console that keeps its history in a LogBuffer and only pushes new lines
+// into the document on a timer, with maximumBlockCount matching the buffer.
+class ConsoleView : public QPlainTextEdit {
+    Q_OBJECT
+
+public:
+    explicit ConsoleView(QWidget *parent = nullptr);
+    void append(const QString &text);
+    void clearLog();
+    void setMaxLines(int lines);
+    int maxLines() const;
+    void setFlushInterval(int milliseconds);
+    QStringList history() const;
+
+private:
+    void flushPending();
+
+    LogBuffer buffer;
+    int pendingLines = 0;
+    QTimer flushTimer;
+};
+
+#endif // CONSOLEVIEW_H
@@ -0,0 +1,118 @@
+#include "cookiemanager.h"
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+
+static const QFileDevice::Permissions PrivateFile = QFileDevice::ReadOwner | QFileDevice::WriteOwner;
+
+CookieManager::CookieManager(HelperProcessRegistry *registry, QObject *parent) : QObject(parent), registry(registry) {
+}
+
+CookieManager::~CookieManager() {
+    // Nothing but this instance knows about them, and they're somebody's logins
+    QDir dir(directory());
+    const QStringList files = dir.entryList(QStringList() << QString("%1-*").arg(QCoreApplication::applicationPid()), QDir::Files);
+    for (const QString &file : files) {
+        QFile::remove(dir.filePath(file));
+    }
+}
+
+QString CookieManager::directory() {
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation) + "/ytdlpfrontend-cookies";
+    QDir().mkpath(dir);
+    QFile::setPermissions(dir, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+    return dir;
+}
+
+bool CookieManager::prepare(const QString &browser) {
+    Jar &jar = jars[browser];
+    QDateTime now = QDateTime::currentDateTime();
+    if (jar.extracting) {
+        return false;
+    }
+    if (!jar.path.isEmpty() && jar.extractedAt.secsTo(now) <= MaxAgeSecs) {
+        return true;
+    }
+    if (jar.failedAt.isValid() && jar.failedAt.secsTo(now) <= RetryAfterFailureSecs) {
+        return true;
+    }
+    extract(browser);
+    return false;
+}
+
+QString CookieManager::jobCopy(const QString &browser, int jobId) {
+    auto it = jars.constFind(browser);
+    if (it == jars.constEnd() || it->path.isEmpty() || it->extracting || it->extractedAt.secsTo(QDateTime::currentDateTime()) > MaxAgeSecs) {
+        return QString();
+    }
+    QString copyPath = QString("%1/%2-job-%3.txt").arg(directory()).arg(QCoreApplication::applicationPid()).arg(jobId);
+    QFile::remove(copyPath);
+    if (!QFile::copy(it->path, copyPath)) {
+        return QString();
+    }
+    QFile::setPermissions(copyPath, PrivateFile);
+    return copyPath;
+}
+
+void CookieManager::invalidate(const QString &browser) {
+    auto it = jars.find(browser);
+    if (it != jars.end() && !it->extracting) {
+        it->extractedAt = QDateTime();
+    }
+}
+
+void CookieManager::extract(const QString &browser) {
+    Jar &jar = jars[browser];
+    jar.extracting = true;
+    QString name = QCryptographicHash::hash(browser.toUtf8(), QCryptographicHash::Sha1).toHex().left(10);
+    if (jar.path.isEmpty()) {
+        jar.path = QString("%1/%2-%3.txt").arg(directory()).arg(QCoreApplication::applicationPid()).arg(name);
+    }
+    QString tempPath = jar.path + ".new";
+    QFile::remove(tempPath);
+    // Without a URL yt-dlp only loads the cookies and saves them to --cookies on the way out.
+    // It complains about the missing URL, so success is judged by the jar, not the exit code
+    QStringList args = {"--ignore-config", "--no-warnings", "--cookies-from-browser", browser, "--cookies", tempPath};
+    QProcess *process = registry->request("cookies", args, false);
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process, browser, tempPath]() {
+        onExtractionFinished(process, browser, tempPath);
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, process, browser, tempPath](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            onExtractionFinished(process, browser, tempPath);
+        }
+    });
+}
+
+void CookieManager::onExtractionFinished(QProcess *process, const QString &browser, const QString &tempPath) {
+    Jar &jar = jars[browser];
+    if (!jar.extracting) {
+        return;
+    }
+    jar.extracting = false;
+    QString errors = QString::fromUtf8(process->readAllStandardError()).trimmed();
+    if (process->error() == QProcess::FailedToStart) {
+        errors = "Couldn't start yt-dlp: " + process->errorString();
+    }
+    process->deleteLater();
+    if (QFileInfo(tempPath).size() > 0) {
+        QFile::setPermissions(tempPath, PrivateFile);
+        QFile::remove(jar.path);
+        if (QFile::rename(tempPath, jar.path)) {
+            jar.extractedAt = QDateTime::currentDateTime();
+            jar.failedAt = QDateTime();
+            emit ready(browser);
+            return;
+        }
+    }
+    QFile::remove(tempPath);
+    jar.extractedAt = QDateTime();
+    jar.failedAt = QDateTime::currentDateTime();
+    QStringList lines = errors.split('\n', Qt::SkipEmptyParts);
+    emit extractionFailed(browser, lines.isEmpty() ? "yt-dlp saved no cookies" : lines.last());
+    // Waiting jobs carry on with --cookies-from-browser
+    emit ready(browser);
+}
@@ -0,0 +1,55 @@
+#ifndef COOKIEMANAGER_H
+#define COOKIEMANAGER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QHash>
+#include <QDateTime>
+#include "helperprocesses.h"
+
+// Reads a browser's cookies (--cookies-from-browser) once into a private
+// Netscape cookie jar, instead of every yt-dlp opening and decrypting the
+// browser's database again. Each download gets its own copy of the jar,
+// because yt-dlp writes the jar back when it exits. A jar older than
+// MaxAgeSecs, or one that got a download a 403, is extracted again; if
+// extracting fails, downloads go back to --cookies-from-browser for a
+// while. Jars live in the runtime directory, readable by the user only.
+class CookieManager : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int MaxAgeSecs = 30 * 60;
+    static constexpr int RetryAfterFailureSecs = 5 * 60;
+
+    explicit CookieManager(HelperProcessRegistry *registry, QObject *parent = nullptr);
+    ~CookieManager();
+
+    // browser is yt-dlp's browser[:profile]. True when a job can start right
+    // away (with a fresh jar, or without one after a failed extraction),
+    // otherwise an extraction is running and ready() follows
+    bool prepare(const QString &browser);
+    // Copy of the jar for one job, empty when there's no fresh jar
+    QString jobCopy(const QString &browser, int jobId);
+    void invalidate(const QString &browser);
+
+signals:
+    void ready(const QString &browser);
+    void extractionFailed(const QString &browser, const QString &error);
+
+private:
+    struct Jar {
+        QString path;
+        QDateTime extractedAt;
+        QDateTime failedAt;
+        bool extracting = false;
+    };
+
+    static QString directory();
+    void extract(const QString &browser);
+    void onExtractionFinished(QProcess *process, const QString &browser, const QString &tempPath);
+
+    HelperProcessRegistry *registry;
+    QHash<QString, Jar> jars;
+};
+
+#endif // COOKIEMANAGER_H
@@ -0,0 +1,86 @@
+#include "downloadarchive.h"
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+QString DownloadArchive::pathFor(const QString &bookmarkUrl) {
+    // Called for every command preview refresh, so no regex and no filesystem here
+    static const QString archiveDir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/ytdlpfrontend/archives";
+    // Readable name for people poking around, hash so m./www./co.uk versions of a channel don't collide
+    QString name = bookmarkUrl.section('/', -1);
+    for (QChar &c : name) {
+        if (!(c.isLetterOrNumber() && c.unicode() < 128) && c != '@' && c != '_' && c != '.' && c != '-') {
+            c = '_';
+        }
+    }
+    QString hash = QCryptographicHash::hash(bookmarkUrl.toUtf8(), QCryptographicHash::Sha1).toHex().left(10);
+    return archiveDir + "/" + name + "-" + hash + ".txt";
+}
+
+bool DownloadArchive::createDirectory(const QString &path) {
+    return QDir().mkpath(QFileInfo(path).path());
+}
+
+bool DownloadArchive::load(const QString &path) {
+    clear();
+    filePath = path;
+    readNew();
+    return QFile::exists(path);
+}
+
+QStringList DownloadArchive::refresh() {
+    if (filePath.isEmpty()) {
+        return QStringList();
+    }
+    // Shorter than what we read means somebody rewrote it, start over
+    if (QFile(filePath).size() < readOffset) {
+        videoIds.clear();
+        readOffset = 0;
+    }
+    return readNew();
+}
+
+void DownloadArchive::clear() {
+    filePath.clear();
+    videoIds.clear();
+    readOffset = 0;
+}
+
+bool DownloadArchive::contains(const QString &videoId) const {
+    return !videoId.isEmpty() && videoIds.contains(videoId);
+}
+
+const QSet<QString> &DownloadArchive::ids() const {
+    return videoIds;
+}
+
+QString DownloadArchive::path() const {
+    return filePath;
+}
+
+QStringList DownloadArchive::readNew() {
+    QStringList added;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(readOffset)) {
+        return added;
+    }
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (!line.endsWith('\n')) {
+            // yt-dlp is halfway through writing this one, pick it up next time
+            break;
+        }
+        readOffset = file.pos();
+        QList<QByteArray> parts = line.trimmed().split(' ');
+        if (parts.size() == 2 && parts.at(0) == "youtube") {
+            QString id = QString::fromLatin1(parts.at(1));
+            if (!videoIds.contains(id)) {
+                videoIds.insert(id);
+                added << id;
+            }
+        }
+    }
+    return added;
+}
@@ -0,0 +1,33 @@
+#ifndef DOWNLOADARCHIVE_H
+#define DOWNLOADARCHIVE_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+
+// A yt-dlp --download-archive file ("youtube <id>" per line) kept in
+// memory as a set of YouTube video ids. yt-dlp only ever appends to it,
+// so refresh() reads just the lines added since the last read.
+class DownloadArchive {
+public:
+    // One archive per bookmark, under the config directory
+    static QString pathFor(const QString &bookmarkUrl);
+    // yt-dlp doesn't create the archive's folder, call before handing it a path
+    static bool createDirectory(const QString &path);
+
+    bool load(const QString &path);
+    QStringList refresh();
+    void clear();
+    bool contains(const QString &videoId) const;
+    const QSet<QString> &ids() const;
+    QString path() const;
+
+private:
+    QStringList readNew();
+
+    QString filePath;
+    QSet<QString> videoIds;
+    qint64 readOffset = 0;
+};
+
+#endif // DOWNLOADARCHIVE_H
@@ -0,0 +1,167 @@
+#include "downloadoptions.h"
+#include "outputparser.h"
+#include <QDir>
+#include <QCache>
+#include <QMutex>
+#include <QHashFunctions>
+
+QString DownloadOptions::finalOutputDir() const {
+    if (!useSubdir) {
+        return outputDir;
+    }
+    return QDir(outputDir).filePath(subdirName.trimmed().isEmpty() ? "yt-dlp output" : subdirName.trimmed());
+}
+
+bool DownloadOptions::hasCredentials() const {
+    return !username.isEmpty() || !cookiesFile.isEmpty() || !cookiesFromBrowser.isEmpty();
+}
+
+size_t qHash(const DownloadOptions &options, size_t seed) {
+    return std::apply([seed](const auto &...field) {
+        return qHashMulti(seed, field...);
+    }, options.fields());
+}
+
+static QStringList buildArgs(const DownloadOptions &options) {
+    QStringList args;
+    args << "--progress" << "--newline" << "--progress-template" << OutputParser::progressTemplate();
+
+    // General Options
+    if (options.ignoreConfig) {
+        args << "--ignore-config";
+    }
+    if (options.continueOnErrors) {
+        args << "--ignore-errors";
+    }
+    if (options.forceGenericExtractor) {
+        args << "--force-generic-extractor";
+    }
+    if (options.legacyServerConnect) {
+        args << "--legacy-server-connect";
+    }
+    if (options.noCheckCertificate) {
+        args << "--no-check-certificate";
+    }
+    if (options.embedThumbnail) {
+        args << "--embed-thumbnail";
+    }
+    if (options.addMetadata) {
+        args << "--add-metadata";
+    }
+    if (options.embedInfoJson) {
+        args << "--embed-info-json";
+    }
+    if (options.embedChapters) {
+        args << "--embed-chapters";
+    }
+    if (options.sleepInterval > 0) {
+        args << "--sleep-interval" << QString::number(options.sleepInterval);
+    }
+    if (options.waitForVideo > 0) {
+        args << "--wait-for-video" << QString::number(options.waitForVideo);
+    }
+    if (!options.impersonate.isEmpty()) {
+        args << "--impersonate" << options.impersonate;
+    }
+    // Playlist Selected Items
+    if (!options.playlistItems.isEmpty()) {
+        args << "--playlist-items" << options.playlistItems;
+    }
+    // Subtitles Options
+    if (options.writeSubs) {
+        args << "--write-subs";
+        if (!options.subLangs.isEmpty()) {
+            args << "--sub-langs" << options.subLangs;
+        }
+        if (options.embedSubs) {
+            args << "--embed-subs";
+        }
+    }
+    // SponsorBlock Options
+    if (options.sponsorBlock) {
+        args << "--sponsorblock-mark" << "all";
+        if (!options.sponsorBlockRemove.isEmpty()) {
+            args << "--sponsorblock-remove" << options.sponsorBlockRemove.join(",");
+        }
+    }
+    // Filename Formatting Options
+    if (options.autoNumber) {
+        args << "--autonumber-start" << "1";
+    }
+    if (options.restrictFilenames) {
+        args << "--restrict-filenames";
+    }
+    if (options.replaceSpaces) {
+        args << "--replace-in-metadata" << "title,uploader,channel" << "\\s" << "_";
+    }
+    if (options.allowUnsafeExt) {
+        args << "--compat-options" << "allow-unsafe-ext";
+    }
+    if (options.forceOverwrites) {
+        args << "--force-overwrites";
+    }
+    QString customFormat = options.filenameFormat.trimmed();
+    if (customFormat.isEmpty()) {
+        customFormat = "%(title)s";
+    }
+    QString extension = "%(ext)s";
+    if (!options.mergeFormat.isEmpty()) {
+        extension = options.mergeFormat;
+        args << "--merge-output-format" << extension;
+    }
+    QString fileName = customFormat + "." + extension;
+    if (!options.outputDirFormat.isEmpty()) {
+        fileName = options.outputDirFormat + QDir::separator() + fileName;
+    }
+    args << "--output" << QDir(options.finalOutputDir()).filePath(fileName);
+    if (options.trimFilenames > 0) {
+        args << "--trim-filenames" << QString::number(options.trimFilenames);
+    }
+    if (!options.downloadArchive.isEmpty()) {
+        args << "--download-archive" << options.downloadArchive;
+    }
+    // Authorization Options
+    if (!options.username.isEmpty()) {
+        args << "--username" << options.username;
+    }
+    if (!options.password.isEmpty()) {
+        args << "--password" << options.password;
+    }
+    // Additional urls from metadata
+    if (!options.parseMetadata.isEmpty()) {
+        args << "--parse-metadata" << options.parseMetadata;
+    }
+    // Cookie Options
+    if (!options.cookiesFile.isEmpty()) {
+        args << "--cookies" << options.cookiesFile;
+    } else if (!options.cookiesFromBrowser.isEmpty()) {
+        args << "--cookies-from-browser" << options.cookiesFromBrowser;
+    }
+    if (!options.downloadSections.isEmpty()) {
+        args << "--download-sections" << options.downloadSections;
+    }
+    if (!options.formatCode.isEmpty()) {
+        args << "-f" << options.formatCode;
+    }
+    if (!options.aria2cArgs.isEmpty()) {
+        args << "--external-downloader" << "aria2c";
+        args << "--external-downloader-args" << options.aria2cArgs;
+    }
+    if (!options.audioFormat.isEmpty()) {
+        args << "-x";
+        args << "--audio-format" << options.audioFormat;
+    }
+    return args;
+}
+
+QStringList toArgs(const DownloadOptions &options) {
+    static QMutex mutex;
+    static QCache<DownloadOptions, QStringList> memo(32);
+    QMutexLocker locker(&mutex);
+    if (const QStringList *args = memo.object(options)) {
+        return *args;
+    }
+    QStringList args = buildArgs(options);
+    memo.insert(options, new QStringList(args));
+    return args;
+}
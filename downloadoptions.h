@@ -0,0 +1,98 @@
+#ifndef DOWNLOADOPTIONS_H
+#define DOWNLOADOPTIONS_H
+
+#include <QString>
+#include <QStringList>
+#include <QSharedPointer>
+#include <tuple>
+
+// Everything that ends up on a yt-dlp download command line, without any
+// widgets attached. The GUI fills one from its tabs whenever they change,
+// headless mode from a bookmark, and both turn it into arguments with
+// toArgs(). Once filled it's only passed around as a DownloadOptionsSnapshot,
+// so queued jobs can keep theirs while the tabs change.
+// The defaults match what the GUI starts with.
+struct DownloadOptions {
+    // General
+    bool ignoreConfig = true;
+    bool continueOnErrors = false;
+    bool forceGenericExtractor = false;
+    bool legacyServerConnect = false;
+    bool noCheckCertificate = false;
+    bool embedThumbnail = true;
+    bool addMetadata = true;
+    bool embedInfoJson = true;
+    bool embedChapters = true;
+    int sleepInterval = 0;          // seconds, 0 = off
+    int waitForVideo = 0;           // seconds, 0 = off
+    QString impersonate;            // empty = off
+    QString aria2cArgs;             // empty = don't use aria2c
+    QString audioFormat;            // empty = keep video
+    QString downloadSections;
+    QString formatCode;
+
+    // Playlist
+    QString playlistItems;
+
+    // Subtitles
+    bool writeSubs = false;
+    QString subLangs;               // "all", a comma list, or empty for yt-dlp's default
+    bool embedSubs = false;
+
+    // SponsorBlock
+    bool sponsorBlock = true;
+    QStringList sponsorBlockRemove = {"sponsor"};
+
+    // Filenames and output
+    bool autoNumber = false;
+    bool restrictFilenames = false;
+    bool replaceSpaces = false;
+    bool allowUnsafeExt = false;
+    bool forceOverwrites = false;
+    QString filenameFormat = "%(title)s";
+    QString mergeFormat;            // empty = yt-dlp picks the container
+    QString outputDirFormat;
+    QString outputDir;
+    bool useSubdir = true;
+    QString subdirName = "yt-dlp output";
+    int trimFilenames = 0;          // 0 = off
+    QString downloadArchive;        // bookmarks get one each, see DownloadArchive
+
+    // Authorization and cookies
+    QString username;
+    QString password;
+    QString parseMetadata;
+    QString cookiesFile;
+    QString cookiesFromBrowser;     // browser[:profile]
+
+    QString finalOutputDir() const;
+    // Logs in or sends cookies, so yt-dlp may see more than an anonymous lookup does
+    bool hasCredentials() const;
+
+    auto fields() const {
+        return std::tie(ignoreConfig, continueOnErrors, forceGenericExtractor, legacyServerConnect, noCheckCertificate,
+                        embedThumbnail, addMetadata, embedInfoJson, embedChapters, sleepInterval, waitForVideo,
+                        impersonate, aria2cArgs, audioFormat, downloadSections, formatCode, playlistItems,
+                        writeSubs, subLangs, embedSubs, sponsorBlock, sponsorBlockRemove,
+                        autoNumber, restrictFilenames, replaceSpaces, allowUnsafeExt, forceOverwrites,
+                        filenameFormat, mergeFormat, outputDirFormat, outputDir, useSubdir, subdirName, trimFilenames, downloadArchive,
+                        username, password, parseMetadata, cookiesFile, cookiesFromBrowser);
+    }
+    bool operator==(const DownloadOptions &other) const {
+        return fields() == other.fields();
+    }
+    bool operator!=(const DownloadOptions &other) const {
+        return !(*this == other);
+    }
+};
+
+using DownloadOptionsSnapshot = QSharedPointer<const DownloadOptions>;
+
+size_t qHash(const DownloadOptions &options, size_t seed = 0);
+
+// The option part of the command line, URLs go after it. Pure, and
+// remembered for recently used option sets, so calling it for every
+// preview update or queued job is cheap. Safe to call from any thread.
+QStringList toArgs(const DownloadOptions &options);
+
+#endif // DOWNLOADOPTIONS_H
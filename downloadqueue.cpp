@@ -0,0 +1,560 @@
+#include "downloadqueue.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QThread>
+#include <QTimer>
+#include "processreaper.h"
+#include "infojsonstore.h"
+#include "urlclassifier.h"
+#include "ytdlpcache.h"
+
+static QString formatEta(qint64 seconds) {
+    if (seconds >= 3600) {
+        return QString("%1:%2:%3").arg(seconds / 3600).arg((seconds / 60) % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+    }
+    return QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+DownloadQueue::DownloadQueue(QObject *parent) : QObject(parent), workerLimit(qMax(1, QThread::idealThreadCount())) {
+    retries = new RetryScheduler(5000, 120000, this);
+    connect(retries, &RetryScheduler::due, this, &DownloadQueue::onRetryDue);
+}
+
+DownloadQueue::~DownloadQueue() {
+    // Quitting shouldn't wait for yt-dlp, the reaper lets them wind down on their own
+    for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+        if (it->process) {
+            ProcessReaper::stop(it->process);
+            it->process = nullptr;
+        }
+    }
+}
+
+int DownloadQueue::enqueue(const QString &label, const DownloadOptionsSnapshot &options, const QStringList &urls) {
+    DownloadJob job;
+    job.id = nextId++;
+    job.label = label;
+    job.options = options;
+    job.urls = urls;
+    job.args = toArgs(*options) + urls;
+    job.outputDir = options->finalOutputDir();
+    job.statusText = "Queued";
+    activeKeys.insert(jobKey(job.args), job.id);
+    jobs.insert(job.id, job);
+    pending.append(job.id);
+    emit jobAdded(job.id);
+    schedule();
+    return job.id;
+}
+
+int DownloadQueue::findActiveJob(const DownloadOptionsSnapshot &options, const QStringList &urls) const {
+    return activeKeys.value(jobKey(toArgs(*options) + urls));
+}
+
+QString DownloadQueue::jobKey(const QStringList &args) {
+    return args.join(QChar(0));
+}
+
+void DownloadQueue::releaseKey(const DownloadJob &job) {
+    // A cancelled job that's still winding down may already share its key with a newer one
+    QString key = jobKey(job.args);
+    auto it = activeKeys.find(key);
+    if (it != activeKeys.end() && it.value() == job.id) {
+        activeKeys.erase(it);
+    }
+}
+
+void DownloadQueue::cancel(int id) {
+    cancelJob(id);
+    checkIdle();
+}
+
+void DownloadQueue::cancelJob(int id) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || !it->isActive()) {
+        return;
+    }
+    if (it->process) {
+        // Give yt-dlp a moment to stop by itself before killing it
+        it->state = DownloadJob::State::Cancelled;
+        it->statusText = "Cancelling...";
+        it->process->terminate();
+        QTimer::singleShot(ProcessReaper::DefaultGraceMs, it->process, &QProcess::kill);
+    } else if (it->workerTicket) {
+        it->state = DownloadJob::State::Cancelled;
+        it->statusText = "Cancelling...";
+        workerPool->cancel(it->workerTicket);
+    } else {
+        pending.removeAll(id);
+        cookieWaiting.removeAll(id);
+        retries->cancel(id);
+        it->state = DownloadJob::State::Cancelled;
+        it->statusText = "Cancelled";
+        emit jobFinished(id);
+    }
+    releaseKey(it.value());
+    emit jobChanged(id);
+}
+
+void DownloadQueue::cancelAll() {
+    // Drop the backlog first so finishing jobs don't start queued ones
+    const QList<int> queued = pending;
+    for (int id : queued) {
+        cancelJob(id);
+    }
+    const QList<int> ids = jobs.keys();
+    for (int id : ids) {
+        cancelJob(id);
+    }
+    // Once, not per job, queueIdle() starts the cache cleanup
+    checkIdle();
+}
+
+void DownloadQueue::retry(int id) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || (it->state != DownloadJob::State::Failed && it->state != DownloadJob::State::Cancelled && it->state != DownloadJob::State::Skipped)) {
+        return;
+    }
+    it->state = DownloadJob::State::Queued;
+    it->statusText = "Queued (retry)";
+    it->progress = 0;
+    it->autoRetries = 0;
+    activeKeys.insert(jobKey(it->args), id);
+    pending.append(id);
+    emit jobChanged(id);
+    schedule();
+}
+
+bool DownloadQueue::skip(int id, const QString &reason) {
+    // Only jobs that haven't started yet, a running one is left to finish or fail on its own
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->state != DownloadJob::State::Queued || it->isRunning()) {
+        return false;
+    }
+    pending.removeAll(id);
+    cookieWaiting.removeAll(id);
+    retries->cancel(id);
+    it->state = DownloadJob::State::Skipped;
+    it->statusText = "Skipped: " + reason;
+    releaseKey(it.value());
+    emit jobChanged(id);
+    emit jobFinished(id);
+    checkIdle();
+    return true;
+}
+
+void DownloadQueue::setLabel(int id, const QString &label) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->label == label) {
+        return;
+    }
+    it->label = label;
+    emit jobChanged(id);
+}
+
+void DownloadQueue::removeFinished() {
+    for (auto it = jobs.begin(); it != jobs.end(); ) {
+        if (!it->isActive() && !it->isRunning()) {
+            int id = it.key();
+            it = jobs.erase(it);
+            emit jobRemoved(id);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DownloadQueue::setMaxWorkers(int count) {
+    workerLimit = qMax(1, count);
+    schedule();
+}
+
+void DownloadQueue::setWorkerPool(WorkerPool *pool) {
+    workerPool = pool;
+    connect(pool, &WorkerPool::output, this, &DownloadQueue::onWorkerOutput);
+    connect(pool, &WorkerPool::finished, this, [this](int ticket, int exitCode, QProcess::ExitStatus exitStatus) {
+        onJobFinished(ticketJobs.value(ticket), exitCode, exitStatus);
+    });
+    connect(pool, &WorkerPool::failedToStart, this, &DownloadQueue::onWorkerFailedToStart);
+}
+
+void DownloadQueue::setCookieManager(CookieManager *manager) {
+    cookieManager = manager;
+    connect(manager, &CookieManager::ready, this, &DownloadQueue::onCookiesReady);
+}
+
+int DownloadQueue::maxWorkers() const {
+    return workerLimit;
+}
+
+void DownloadQueue::setAutoRetries(int count) {
+    retryLimit = qMax(0, count);
+}
+
+int DownloadQueue::autoRetries() const {
+    return retryLimit;
+}
+
+int DownloadQueue::runningCount() const {
+    return running;
+}
+
+int DownloadQueue::queuedCount() const {
+    return pending.size();
+}
+
+QList<int> DownloadQueue::pendingJobs() const {
+    return pending;
+}
+
+int DownloadQueue::averageActiveProgress() const {
+    int total = 0;
+    int count = 0;
+    for (auto it = jobs.constBegin(); it != jobs.constEnd(); ++it) {
+        if (it->isActive()) {
+            total += it->progress;
+            count++;
+        }
+    }
+    return count > 0 ? total / count : 0;
+}
+
+bool DownloadQueue::isIdle() const {
+    return running == 0 && pending.isEmpty() && cookieWaiting.isEmpty() && !retries->hasPending();
+}
+
+DownloadJob DownloadQueue::job(int id) const {
+    return jobs.value(id);
+}
+
+QList<int> DownloadQueue::jobIds() const {
+    return jobs.keys();
+}
+
+void DownloadQueue::schedule() {
+    while (running < workerLimit && !pending.isEmpty()) {
+        int id = pending.takeFirst();
+        auto it = jobs.find(id);
+        if (it == jobs.end() || it->state != DownloadJob::State::Queued || !cookiesReady(it.value())) {
+            continue;
+        }
+        startJob(it.value());
+    }
+}
+
+bool DownloadQueue::cookiesReady(DownloadJob &job) {
+    // Same precedence as toArgs(), a cookies file wins over the browser
+    if (!cookieManager || !job.options->cookiesFile.isEmpty() || job.options->cookiesFromBrowser.isEmpty()) {
+        return true;
+    }
+    if (cookieManager->prepare(job.options->cookiesFromBrowser)) {
+        return true;
+    }
+    cookieWaiting.append(job.id);
+    job.statusText = "Waiting for browser cookies";
+    emit jobChanged(job.id);
+    return false;
+}
+
+void DownloadQueue::onCookiesReady(const QString &browser) {
+    // Back to the front of the line, in the order they were parked
+    QList<int> ready;
+    for (int id : std::as_const(cookieWaiting)) {
+        auto it = jobs.constFind(id);
+        if (it != jobs.constEnd() && it->options->cookiesFromBrowser == browser) {
+            ready.append(id);
+        }
+    }
+    for (int i = ready.size() - 1; i >= 0; --i) {
+        cookieWaiting.removeAll(ready.at(i));
+        pending.prepend(ready.at(i));
+    }
+    schedule();
+}
+
+void DownloadQueue::startJob(DownloadJob &job) {
+    int id = job.id;
+    job.state = DownloadJob::State::Downloading;
+    job.statusText = "Downloading";
+    job.progress = 0;
+    job.speed.clear();
+    job.eta.clear();
+    job.downloadedBytes = -1;
+    job.totalBytes = -1;
+    job.fragmentIndex = -1;
+    job.fragmentCount = -1;
+    job.attempts++;
+    job.files.clear();
+    job.outputParser = OutputParser();
+    job.errorParser = OutputParser();
+    job.startTime = QDateTime::currentDateTime();
+    running++;
+
+    QStringList args = job.args;
+    job.infoJson.clear();
+    // Saved info comes from anonymous lookups, a job with a login or cookies may get other formats
+    if (!job.freshExtraction && job.urls.size() == 1 && !job.options->hasCredentials()) {
+        UrlInfo info = UrlClassifier::classify(job.urls.first());
+        if (info.kind == UrlInfo::Kind::Video || info.kind == UrlInfo::Kind::Short) {
+            job.infoJson = InfoJsonStore::freshPath(info.videoId);
+        }
+    }
+    if (!job.infoJson.isEmpty()) {
+        args = toArgs(*job.options) + QStringList{"--load-info-json", job.infoJson};
+        emit jobOutput(id, "Starting from saved video info: " + job.infoJson);
+    }
+    job.forbidden = false;
+    job.cookieJar.clear();
+    if (cookieManager && job.options->cookiesFile.isEmpty() && !job.options->cookiesFromBrowser.isEmpty()) {
+        // Its own copy, yt-dlp writes the jar back when it exits
+        job.cookieJar = cookieManager->jobCopy(job.options->cookiesFromBrowser, id);
+        int index = args.indexOf("--cookies-from-browser");
+        if (!job.cookieJar.isEmpty() && index >= 0 && index + 1 < args.size()) {
+            args[index] = "--cookies";
+            args[index + 1] = job.cookieJar;
+        }
+    }
+    args = YtdlpCache::args() + args;
+
+    if (workerPool && workerPool->isUsable()) {
+        job.workerTicket = workerPool->run(args);
+        ticketJobs.insert(job.workerTicket, id);
+        emit jobChanged(id);
+        return;
+    }
+
+    job.process = new QProcess(this);
+    QProcess *process = job.process;
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, id]() {
+        onJobOutput(id);
+    });
+    connect(process, &QProcess::readyReadStandardError, this, [this, id]() {
+        onJobErrorOutput(id);
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, id, process](QProcess::ProcessError error) {
+        // A process that never started won't emit finished()
+        if (error == QProcess::FailedToStart) {
+            emit jobOutput(id, "Process error: " + process->errorString());
+            onJobFinished(id, -1, QProcess::CrashExit);
+        }
+    });
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, id](int exitCode, QProcess::ExitStatus exitStatus) {
+        onJobFinished(id, exitCode, exitStatus);
+    });
+
+    emit jobChanged(id);
+    process->start("yt-dlp", args);
+}
+
+void DownloadQueue::onJobOutput(int id) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || !it->process) {
+        return;
+    }
+    DownloadJob &job = it.value();
+    applyEvents(job, job.outputParser.feed(job.process->readAllStandardOutput()));
+}
+
+void DownloadQueue::onJobErrorOutput(int id) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || !it->process) {
+        return;
+    }
+    DownloadJob &job = it.value();
+    applyEvents(job, job.errorParser.feed(job.process->readAllStandardError()));
+}
+
+void DownloadQueue::onWorkerOutput(int ticket, const QByteArray &data, bool isError) {
+    auto it = jobs.find(ticketJobs.value(ticket));
+    if (it == jobs.end() || it->workerTicket != ticket) {
+        return;
+    }
+    DownloadJob &job = it.value();
+    applyEvents(job, isError ? job.errorParser.feed(data) : job.outputParser.feed(data));
+}
+
+void DownloadQueue::onWorkerFailedToStart(int ticket, const QString &reason) {
+    int id = ticketJobs.take(ticket);
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->workerTicket != ticket) {
+        return;
+    }
+    it->workerTicket = 0;
+    running--;
+    if (it->state == DownloadJob::State::Cancelled) {
+        it->statusText = "Cancelled";
+        emit jobChanged(id);
+        emit jobFinished(id);
+        checkIdle();
+        return;
+    }
+    // The pool has turned itself off by now, so this time it gets its own process
+    emit jobOutput(id, "Python worker unavailable (" + reason + "), running yt-dlp directly");
+    it->state = DownloadJob::State::Queued;
+    it->statusText = "Queued";
+    it->attempts--;
+    pending.prepend(id);
+    emit jobChanged(id);
+    schedule();
+}
+
+void DownloadQueue::applyEvents(DownloadJob &job, const QVector<OutputEvent> &events) {
+    if (events.isEmpty()) {
+        return;
+    }
+    for (const OutputEvent &event : events) {
+        emit jobOutput(job.id, event.line);
+        // Only yt-dlp's final error, fragment retries it recovers from print 403s too
+        if (event.line.trimmed().startsWith("ERROR:") && event.line.contains("HTTP Error 403")) {
+            job.forbidden = true;
+        }
+        if (job.state == DownloadJob::State::Cancelled) {
+            continue;
+        }
+        switch (event.type) {
+        case OutputEvent::Type::Destination:
+            job.files.append(event.path);
+            job.state = DownloadJob::State::Downloading;
+            job.statusText = "Downloading";
+            break;
+        case OutputEvent::Type::Merger:
+            job.files.append(event.path);
+            job.state = DownloadJob::State::PostProcessing;
+            job.progress = 100;
+            job.statusText = "Post-processing...";
+            break;
+        case OutputEvent::Type::PostProcessor:
+            job.state = DownloadJob::State::PostProcessing;
+            job.progress = 100;
+            job.statusText = "Post-processing...";
+            break;
+        case OutputEvent::Type::Progress:
+            if (job.state == DownloadJob::State::Downloading) {
+                if (event.percent >= 0) {
+                    job.progress = static_cast<int>(event.percent);
+                }
+                job.speed = event.speedBytes >= 0 ? QLocale().formattedDataSize(static_cast<qint64>(event.speedBytes)) + "/s" : event.speed;
+                job.eta = event.etaSeconds >= 0 ? formatEta(static_cast<qint64>(event.etaSeconds)) : event.eta;
+                job.downloadedBytes = static_cast<qint64>(event.downloadedBytes);
+                job.totalBytes = static_cast<qint64>(event.totalBytes);
+                job.fragmentIndex = event.fragmentIndex;
+                job.fragmentCount = event.fragmentCount;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    emit jobChanged(job.id);
+}
+
+void DownloadQueue::onJobFinished(int id, int exitCode, QProcess::ExitStatus exitStatus) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || !it->isRunning()) {
+        return;
+    }
+    DownloadJob &job = it.value();
+    applyEvents(job, job.outputParser.flush());
+    applyEvents(job, job.errorParser.flush());
+    if (job.process) {
+        job.process->deleteLater();
+        job.process = nullptr;
+    }
+    ticketJobs.remove(job.workerTicket);
+    job.workerTicket = 0;
+    running--;
+    if (!job.cookieJar.isEmpty()) {
+        // A 403 can mean the session cookies went stale, the next attempt gets a fresh jar
+        bool failed = exitStatus != QProcess::NormalExit || exitCode != 0;
+        if (job.forbidden && failed && job.state != DownloadJob::State::Cancelled) {
+            cookieManager->invalidate(job.options->cookiesFromBrowser);
+        }
+        QFile::remove(job.cookieJar);
+        job.cookieJar.clear();
+    }
+
+    if (job.state == DownloadJob::State::Cancelled) {
+        cleanupFiles(job);
+        job.statusText = "Cancelled";
+    } else if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+        job.state = DownloadJob::State::Finished;
+        job.statusText = "Finished";
+        job.progress = 100;
+    } else if (exitStatus == QProcess::NormalExit && !job.infoJson.isEmpty()) {
+        // Most likely the saved stream URLs expired, so extract from the URL right away.
+        // Doesn't count as a retry, the saved info was at fault and not the download
+        QFile::remove(job.infoJson);
+        job.infoJson.clear();
+        job.freshExtraction = true;
+        job.state = DownloadJob::State::Queued;
+        job.statusText = "Saved video info didn't work, extracting again";
+        emit jobOutput(id, job.statusText);
+        pending.prepend(id);
+        emit jobChanged(id);
+        schedule();
+        return;
+    } else if (exitStatus == QProcess::NormalExit && job.autoRetries < retryLimit) {
+        // Usually a network hiccup or rate limit, so wait a bit and let it queue itself again.
+        // Crashes (and a missing yt-dlp) would fail the same way again, those aren't retried
+        job.autoRetries++;
+        int delay = retries->schedule(id, job.autoRetries);
+        job.state = DownloadJob::State::Queued;
+        job.statusText = QString("Failed (exit code %1), retrying in %2s").arg(exitCode).arg((delay + 999) / 1000);
+        emit jobOutput(id, job.statusText);
+        emit jobChanged(id);
+        schedule();
+        return;
+    } else {
+        job.state = DownloadJob::State::Failed;
+        job.statusText = exitStatus == QProcess::CrashExit ? "Crashed" : QString("Failed (exit code %1)").arg(exitCode);
+    }
+    releaseKey(job);
+    emit jobChanged(id);
+    emit jobFinished(id);
+
+    schedule();
+    checkIdle();
+}
+
+void DownloadQueue::onRetryDue(int id) {
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->state != DownloadJob::State::Queued || it->isRunning()) {
+        return;
+    }
+    it->statusText = "Queued (retry)";
+    pending.append(id);
+    emit jobChanged(id);
+    schedule();
+}
+
+void DownloadQueue::checkIdle() {
+    if (isIdle()) {
+        emit queueIdle();
+    }
+}
+
+void DownloadQueue::cleanupFiles(DownloadJob &job) {
+    for (const QString &file : job.files) {
+        for (const QString &path : {file, file + ".part", file + ".ytdl"}) {
+            if (QFile::exists(path) && QFile::remove(path)) {
+                emit jobOutput(job.id, "Deleted file: " + path);
+            }
+        }
+    }
+    // Sweeping stray .part files is only safe when no other job writes into the same folder
+    for (auto it = jobs.constBegin(); it != jobs.constEnd(); ++it) {
+        if (it->isRunning() && it->outputDir == job.outputDir) {
+            return;
+        }
+    }
+    QDir dir(job.outputDir);
+    QStringList partFiles = dir.entryList(QStringList() << "*.part", QDir::Files);
+    for (const QString &partFile : partFiles) {
+        if (QFileInfo(dir.filePath(partFile)).birthTime() > job.startTime) {
+            QFile::remove(dir.filePath(partFile));
+            emit jobOutput(job.id, "Deleted file: " + partFile);
+        }
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef DOWNLOADQUEUE_H
+#define DOWNLOADQUEUE_H
+
+#include <QObject>
+#include <QProcess>
+#include <QDateTime>
+#include <QStringList>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include "outputparser.h"
+#include "retryscheduler.h"
+#include "downloadoptions.h"
+#include "workerpool.h"
+#include "cookiemanager.h"
+
+struct DownloadJob {
+    enum class State { Queued, Downloading, PostProcessing, Finished, Failed, Cancelled, Skipped };
+
+    int id = 0;
+    QString label;
+    DownloadOptionsSnapshot options;
+    QStringList urls;
+    QStringList args;
+    // --load-info-json file the current attempt started from, if any
+    QString infoJson;
+    // Set once saved info failed, the job extracts by itself from then on
+    bool freshExtraction = false;
+    // This attempt's copy of the CookieManager jar, if any
+    QString cookieJar;
+    // yt-dlp gave up with an HTTP 403 error during this attempt
+    bool forbidden = false;
+    QString outputDir;
+    State state = State::Queued;
+    QString statusText;
+    int progress = 0;
+    QString speed;
+    QString eta;
+    qint64 downloadedBytes = -1;
+    qint64 totalBytes = -1;
+    int fragmentIndex = -1;
+    int fragmentCount = -1;
+    int attempts = 0;
+    int autoRetries = 0;
+    QStringList files;
+    QDateTime startTime;
+    QProcess *process = nullptr;
+    // Set instead of process while the job runs in a python worker
+    int workerTicket = 0;
+    OutputParser outputParser;
+    OutputParser errorParser;
+
+    bool isActive() const {
+        return state == State::Queued || state == State::Downloading || state == State::PostProcessing;
+    }
+
+    bool isRunning() const {
+        return process || workerTicket;
+    }
+};
+
+// Runs yt-dlp jobs with at most maxWorkers() processes alive at once.
+// Jobs are snapshots of the argument list at the time they were queued,
+// so the UI can keep changing while earlier jobs run. A job that fails is
+// queued again by itself up to autoRetries() times, with a growing delay.
+// A single video with fresh info JSON in the InfoJsonStore starts from that
+// instead of extracting again (unless it logs in or sends cookies); if that
+// fails it's run again from the URL.
+// With a usable WorkerPool set, jobs run in its python workers instead of
+// their own yt-dlp process. With a CookieManager set, --cookies-from-browser
+// jobs wait for its jar and run with their own copy of it instead.
+class DownloadQueue : public QObject {
+    Q_OBJECT
+
+public:
+    explicit DownloadQueue(QObject *parent = nullptr);
+    ~DownloadQueue();
+
+    int enqueue(const QString &label, const DownloadOptionsSnapshot &options, const QStringList &urls);
+    // Active (queued or running) job with the same options and URLs, 0 if none
+    int findActiveJob(const DownloadOptionsSnapshot &options, const QStringList &urls) const;
+    void cancel(int id);
+    void cancelAll();
+    void retry(int id);
+    bool skip(int id, const QString &reason);
+    void setLabel(int id, const QString &label);
+    void removeFinished();
+
+    void setMaxWorkers(int count);
+    void setWorkerPool(WorkerPool *pool);
+    void setCookieManager(CookieManager *manager);
+    void setAutoRetries(int count);
+    int autoRetries() const;
+    int maxWorkers() const;
+    int runningCount() const;
+    int queuedCount() const;
+    QList<int> pendingJobs() const;
+    int averageActiveProgress() const;
+    bool isIdle() const;
+
+    DownloadJob job(int id) const;
+    QList<int> jobIds() const;
+
+signals:
+    void jobAdded(int id);
+    void jobChanged(int id);
+    void jobFinished(int id);
+    void jobRemoved(int id);
+    void jobOutput(int id, const QString &text);
+    void queueIdle();
+
+private:
+    void schedule();
+    // cancel() without the idle check
+    void cancelJob(int id);
+    bool cookiesReady(DownloadJob &job);
+    void onCookiesReady(const QString &browser);
+    void startJob(DownloadJob &job);
+    void onJobOutput(int id);
+    void onJobErrorOutput(int id);
+    void onWorkerOutput(int ticket, const QByteArray &data, bool isError);
+    void onWorkerFailedToStart(int ticket, const QString &reason);
+    void applyEvents(DownloadJob &job, const QVector<OutputEvent> &events);
+    void onJobFinished(int id, int exitCode, QProcess::ExitStatus exitStatus);
+    void onRetryDue(int id);
+    void cleanupFiles(DownloadJob &job);
+    void checkIdle();
+    static QString jobKey(const QStringList &args);
+    void releaseKey(const DownloadJob &job);
+
+    QMap<int, DownloadJob> jobs;
+    QList<int> pending;
+    // jobKey() of every active job, so duplicate checks don't walk all jobs
+    QHash<QString, int> activeKeys;
+    int nextId = 1;
+    int running = 0;
+    int workerLimit;
+    int retryLimit = 2;
+    RetryScheduler *retries;
+    WorkerPool *workerPool = nullptr;
+    QHash<int, int> ticketJobs;
+    CookieManager *cookieManager = nullptr;
+    // Queued jobs parked until the cookie jar for their browser is ready
+    QList<int> cookieWaiting;
+};
+
+#endif // DOWNLOADQUEUE_H
@@ -0,0 +1,216 @@
+#include "formatfetcher.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include "urlclassifier.h"
+#include "infojsonstore.h"
+
+static bool hasCodec(const QString &codec) {
+    return !codec.isEmpty() && codec != "none";
+}
+
+QString FormatEntry::codec() const {
+    bool video = hasCodec(vcodec);
+    bool audio = hasCodec(acodec);
+    if (video && audio) {
+        return vcodec + " / " + acodec;
+    }
+    if (video) {
+        return vcodec;
+    }
+    if (audio) {
+        return acodec;
+    }
+    // storyboards and the like
+    return "images";
+}
+
+static FormatEntry parseFormat(const QJsonObject &format) {
+    FormatEntry entry;
+    entry.formatId = format.value("format_id").toString();
+    entry.ext = format.value("ext").toString();
+    entry.resolution = format.value("resolution").toString();
+    entry.vcodec = format.value("vcodec").toString();
+    entry.acodec = format.value("acodec").toString();
+    entry.note = format.value("format_note").toString();
+    entry.height = format.value("height").toInt();
+    entry.fps = format.value("fps").toDouble();
+    entry.tbr = format.value("tbr").toDouble();
+    if (format.value("filesize").isDouble()) {
+        entry.filesize = format.value("filesize").toInteger();
+    } else if (format.value("filesize_approx").isDouble()) {
+        entry.filesize = format.value("filesize_approx").toInteger();
+        entry.approxSize = true;
+    }
+    return entry;
+}
+
+FormatFetcher::FormatFetcher(HelperProcessRegistry *registry, QObject *parent) : QObject(parent), registry(registry) {
+}
+
+QString FormatFetcher::cacheKey(const QString &url) {
+    UrlInfo info = UrlClassifier::classify(url);
+    return info.videoId.isEmpty() ? url : info.videoId;
+}
+
+void FormatFetcher::request(const QStringList &urls, bool refresh) {
+    for (const QString &url : urls) {
+        if (url.isEmpty() || inFlight.contains(url)) {
+            continue;
+        }
+        UrlInfo info = UrlClassifier::classify(url);
+        if (info.isChannel() || (info.isPlaylist() && info.videoId.isEmpty())) {
+            // -J would extract every video in it
+            emit formatsFailed(url, "Formats are listed per video, this is a playlist or channel");
+            continue;
+        }
+        if (refresh) {
+            cache.remove(cacheKey(url));
+        } else if (const VideoFormats *formats = cached(url)) {
+            emit formatsReady(url, *formats);
+            continue;
+        }
+        inFlight.insert(url);
+        queue.append(url);
+    }
+    startNext();
+    if (!isBusy()) {
+        emit idle();
+    }
+}
+
+void FormatFetcher::clearPending() {
+    for (const QString &url : std::as_const(queue)) {
+        inFlight.remove(url);
+    }
+    queue.clear();
+}
+
+void FormatFetcher::setMaxProcesses(int count) {
+    processLimit = qMax(1, count);
+    startNext();
+}
+
+int FormatFetcher::maxProcesses() const {
+    return processLimit;
+}
+
+bool FormatFetcher::isBusy() const {
+    return !queue.isEmpty() || !processes.isEmpty() || parsing > 0;
+}
+
+const VideoFormats *FormatFetcher::cached(const QString &url) const {
+    auto it = cache.constFind(cacheKey(url));
+    if (it == cache.constEnd() || it.value().fetchedAt.secsTo(QDateTime::currentDateTime()) > CacheTtlSecs) {
+        return nullptr;
+    }
+    return &it.value();
+}
+
+VideoFormats FormatFetcher::parse(const QByteArray &json) {
+    VideoFormats result;
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (!document.isObject()) {
+        result.error = parseError.error != QJsonParseError::NoError ? parseError.errorString() : "yt-dlp returned no video info";
+        return result;
+    }
+    QJsonObject info = document.object();
+    result.id = info.value("id").toString();
+    result.title = info.value("title").toString();
+    const QJsonArray formats = info.value("formats").toArray();
+    result.formats.reserve(formats.size());
+    for (const QJsonValue &format : formats) {
+        result.formats.append(parseFormat(format.toObject()));
+    }
+    // Sites with a single format only describe it at the top level
+    if (result.formats.isEmpty() && info.contains("format_id")) {
+        result.formats.append(parseFormat(info));
+    }
+    return result;
+}
+
+void FormatFetcher::startNext() {
+    while (processes.size() < processLimit && !queue.isEmpty()) {
+        QString url = queue.takeFirst();
+        QStringList args = {"-J", "--no-warnings", "--no-playlist", url};
+        QProcess *process = registry->request("formats", args, false);
+        processes.append(process);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process, url]() {
+            onFetchFinished(process, url);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, process, url](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                onFetchFinished(process, url);
+            }
+        });
+    }
+}
+
+void FormatFetcher::onFetchFinished(QProcess *process, const QString &url) {
+    if (!processes.removeOne(process)) {
+        return;
+    }
+    QByteArray output = process->readAllStandardOutput();
+    QString error;
+    if (process->error() == QProcess::FailedToStart) {
+        error = "Couldn't start yt-dlp: " + process->errorString();
+    } else if (process->exitStatus() == QProcess::CrashExit) {
+        error = "yt-dlp crashed";
+    } else if (output.trimmed().isEmpty()) {
+        const QStringList lines = QString::fromUtf8(process->readAllStandardError()).split('\n', Qt::SkipEmptyParts);
+        error = lines.isEmpty() ? "yt-dlp exited with code " + QString::number(process->exitCode()) : lines.last().trimmed();
+    }
+    process->deleteLater();
+    if (!error.isEmpty()) {
+        inFlight.remove(url);
+        emit formatsFailed(url, error);
+    } else {
+        // A long video's JSON is several megabytes, keep that off the GUI thread
+        ++parsing;
+        QFutureWatcher<VideoFormats> *watcher = new QFutureWatcher<VideoFormats>(this);
+        connect(watcher, &QFutureWatcher<VideoFormats>::finished, this, [this, watcher, url]() {
+            --parsing;
+            onParsed(url, watcher->result());
+            watcher->deleteLater();
+        });
+        QString videoId = UrlClassifier::classify(url).videoId;
+        watcher->setFuture(QtConcurrent::run([output, videoId]() {
+            VideoFormats formats = parse(output);
+            // Downloading this video later can start from it instead of extracting again
+            if (formats.error.isEmpty() && !videoId.isEmpty() && formats.id == videoId) {
+                InfoJsonStore::save(videoId, output);
+            }
+            return formats;
+        }));
+    }
+    startNext();
+    if (!isBusy()) {
+        emit idle();
+    }
+}
+
+void FormatFetcher::onParsed(const QString &url, const VideoFormats &parsed) {
+    inFlight.remove(url);
+    if (!parsed.error.isEmpty()) {
+        emit formatsFailed(url, parsed.error);
+    } else {
+        VideoFormats formats = parsed;
+        formats.fetchedAt = QDateTime::currentDateTime();
+        // Expired tables are never shown again, drop them instead of keeping them for the whole session
+        for (auto it = cache.begin(); it != cache.end(); ) {
+            if (it->fetchedAt.secsTo(formats.fetchedAt) > CacheTtlSecs) {
+                it = cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        cache.insert(cacheKey(url), formats);
+        emit formatsReady(url, formats);
+    }
+    if (!isBusy()) {
+        emit idle();
+    }
+}
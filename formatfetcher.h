@@ -0,0 +1,83 @@
+#ifndef FORMATFETCHER_H
+#define FORMATFETCHER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QVector>
+#include <QStringList>
+#include <QDateTime>
+#include "helperprocesses.h"
+
+struct FormatEntry {
+    QString formatId;
+    QString ext;
+    QString resolution;
+    QString vcodec;
+    QString acodec;
+    QString note;
+    int height = 0;
+    double fps = 0;
+    double tbr = 0;
+    qint64 filesize = -1;
+    // filesize is yt-dlp's estimate, not the real size
+    bool approxSize = false;
+
+    QString codec() const;
+};
+
+struct VideoFormats {
+    QString id;
+    QString title;
+    QVector<FormatEntry> formats;
+    QDateTime fetchedAt;
+    QString error;
+};
+
+// Format lists from yt-dlp -J, one run per URL, at most maxProcesses()
+// at once (on top of the registry's own cap). The JSON is parsed on a
+// worker thread and the result kept per video id for CacheTtlSecs, so
+// asking again for a URL already looked up answers right away. Expired
+// entries are dropped whenever a new one comes in. The raw JSON of
+// YouTube videos goes into the InfoJsonStore for downloads.
+class FormatFetcher : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int CacheTtlSecs = 15 * 60;
+
+    explicit FormatFetcher(HelperProcessRegistry *registry, QObject *parent = nullptr);
+
+    void request(const QStringList &urls, bool refresh = false);
+    void clearPending();
+    void setMaxProcesses(int count);
+    int maxProcesses() const;
+    bool isBusy() const;
+    // nullptr when the URL wasn't looked up yet or the entry expired
+    const VideoFormats *cached(const QString &url) const;
+
+    static VideoFormats parse(const QByteArray &json);
+    static QString cacheKey(const QString &url);
+
+signals:
+    void formatsReady(const QString &url, const VideoFormats &formats);
+    void formatsFailed(const QString &url, const QString &error);
+    void idle();
+
+private:
+    void startNext();
+    void onFetchFinished(QProcess *process, const QString &url);
+    void onParsed(const QString &url, const VideoFormats &formats);
+
+    HelperProcessRegistry *registry;
+    QHash<QString, VideoFormats> cache;
+    QStringList queue;
+    QSet<QString> inFlight;
+    QList<QProcess*> processes;
+    int parsing = 0;
+    int processLimit = 3;
+};
+
+#endif // FORMATFETCHER_H
@@ -0,0 +1,229 @@
+#include "headlessrunner.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QTimer>
+#include "downloadarchive.h"
+#include "ytdlpcache.h"
+
+static QTextStream &out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream &err() {
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+static bool openBookmarkDatabase() {
+    if (QSqlDatabase::database().isOpen()) {
+        return true;
+    }
+    QString dbPath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/ytdlpfrontend/ytdlpf-bookmarks.db";
+    if (!QFileInfo::exists(dbPath)) {
+        err() << "Error: No bookmark database at " << dbPath << Qt::endl;
+        return false;
+    }
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(dbPath);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    if (!db.open()) {
+        err() << "Error: Couldn't open database: " << db.lastError().text() << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+HeadlessRunner::HeadlessRunner(QObject *parent) : QObject(parent) {
+    queue = new DownloadQueue(this);
+    workerPool = new WorkerPool(this);
+    workerPool->setMaxWorkers(queue->maxWorkers());
+    queue->setWorkerPool(workerPool);
+    helperProcesses = new HelperProcessRegistry(4, this);
+    cookieManager = new CookieManager(helperProcesses, this);
+    queue->setCookieManager(cookieManager);
+    connect(cookieManager, &CookieManager::extractionFailed, this, [](const QString &browser, const QString &error) {
+        err() << "Error: Couldn't extract cookies from " << browser << ", downloads read the browser themselves: " << error << Qt::endl;
+    });
+    connect(workerPool, &WorkerPool::unavailable, this, [](const QString &reason) {
+        err() << "Python workers unavailable, running yt-dlp directly: " << reason << Qt::endl;
+    });
+    connect(queue, &DownloadQueue::jobOutput, this, [](int id, const QString &text) {
+        out() << QString("[#%1] %2").arg(id).arg(text) << Qt::endl;
+    });
+    connect(queue, &DownloadQueue::jobFinished, this, &HeadlessRunner::onJobFinished);
+    connect(queue, &DownloadQueue::queueIdle, this, [this]() {
+        YtdlpCache::evict();
+        out() << QString("Done: %1 of %2 downloads finished, %3 failed.").arg(queuedJobs - failedJobs).arg(queuedJobs).arg(failedJobs) << Qt::endl;
+        if (queueFailures > 0) {
+            // A mistyped bookmark name in a cron line shouldn't pass as success
+            err() << QString("%1 %2 couldn't be queued.").arg(queueFailures).arg(queueFailures == 1 ? "target" : "targets") << Qt::endl;
+        }
+        emit finished(failedJobs > 0 || queueFailures > 0 ? 1 : 0);
+    });
+}
+
+int HeadlessRunner::run(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Downloads bookmarks or URLs with yt-dlp without opening the window.");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("headless", "Run without the GUI."));
+    QCommandLineOption outputDirOption(QStringList() << "o" << "output-dir", "Where URLs (and bookmarks without their own output directory) are saved.", "dir");
+    QCommandLineOption batchFileOption(QStringList() << "a" << "batch-file", "Read URLs from a file, one per line (# starts a comment).", "file");
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs", "How many downloads run at once.", "count");
+    parser.addOption(outputDirOption);
+    parser.addOption(batchFileOption);
+    QCommandLineOption pythonWorkersOption(QStringList() << "w" << "python-workers", "Run downloads in long-lived python workers that import yt-dlp once (needs yt-dlp installed as a python module).");
+    parser.addOption(jobsOption);
+    QCommandLineOption cookiesFromBrowserOption("cookies-from-browser", "Use this browser's cookies, read once for all downloads (same values as yt-dlp, e.g. firefox or chrome:Profile 1).", "browser[:profile]");
+    parser.addOption(pythonWorkersOption);
+    parser.addOption(cookiesFromBrowserOption);
+    parser.addPositionalArgument("targets", "Bookmark names or URLs (anything starting with http:// or https://).", "[bookmark|url...]");
+    parser.process(app);
+
+    QString outputDir = parser.value(outputDirOption);
+    if (outputDir.isEmpty()) {
+        outputDir = QStandardPaths::writableLocation(QStandardPaths::DownloadLocation);
+        if (outputDir.isEmpty()) {
+            outputDir = QDir::homePath();
+        }
+    }
+    QStringList targets = parser.positionalArguments();
+    if (parser.isSet(batchFileOption)) {
+        QFile batchFile(parser.value(batchFileOption));
+        if (!batchFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            err() << "Error: Couldn't read " << batchFile.fileName() << ": " << batchFile.errorString() << Qt::endl;
+            return 2;
+        }
+        QTextStream in(&batchFile);
+        while (!in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            if (!line.isEmpty() && !line.startsWith('#')) {
+                targets << line;
+            }
+        }
+    }
+    if (targets.isEmpty()) {
+        err() << "Error: Nothing to download, give at least one bookmark name or URL." << Qt::endl;
+        parser.showHelp(2);
+    }
+
+    HeadlessRunner runner;
+    // Queued, so a queue that finishes before exec() still ends the event loop
+    connect(&runner, &HeadlessRunner::finished, &app, &QCoreApplication::exit, Qt::QueuedConnection);
+    if (parser.isSet(jobsOption)) {
+        runner.setMaxWorkers(parser.value(jobsOption).toInt());
+    }
+    runner.setUsePythonWorkers(parser.isSet(pythonWorkersOption));
+    runner.setCookiesFromBrowser(parser.value(cookiesFromBrowserOption));
+    for (const QString &target : std::as_const(targets)) {
+        bool queued;
+        if (target.startsWith("http://", Qt::CaseInsensitive) || target.startsWith("https://", Qt::CaseInsensitive)) {
+            queued = runner.queueUrl(target, outputDir);
+        } else {
+            queued = runner.queueBookmark(target, outputDir);
+        }
+        if (!queued) {
+            runner.queueFailures++;
+        }
+    }
+    if (!runner.hasJobs()) {
+        err() << "Error: Nothing could be queued." << Qt::endl;
+        return 1;
+    }
+    return app.exec();
+}
+
+bool HeadlessRunner::queueBookmark(const QString &name, const QString &fallbackOutputDir) {
+    if (!openBookmarkDatabase()) {
+        return false;
+    }
+    QSqlQuery query;
+    query.prepare("SELECT url, output_dir, filename_format, output_dir_format, use_subdir, subdir_name, selected_format_code FROM bookmarks WHERE name = :name");
+    query.bindValue(":name", name);
+    if (!query.exec()) {
+        err() << "Error retrieving bookmark: " << query.lastError().text() << Qt::endl;
+        return false;
+    }
+    if (!query.next()) {
+        err() << "Error: No bookmark named \"" << name << "\"" << Qt::endl;
+        return false;
+    }
+    // Same fields a bookmark click puts into the GUI, everything else stays at its default
+    DownloadOptions options;
+    options.outputDir = query.value("output_dir").toString();
+    if (options.outputDir.isEmpty()) {
+        options.outputDir = fallbackOutputDir;
+    }
+    QString filenameFormat = query.value("filename_format").toString();
+    if (!filenameFormat.isEmpty()) {
+        options.filenameFormat = filenameFormat;
+    }
+    options.outputDirFormat = query.value("output_dir_format").toString();
+    options.useSubdir = query.value("use_subdir").toBool();
+    QString subdirName = query.value("subdir_name").toString();
+    if (!subdirName.isEmpty()) {
+        options.subdirName = subdirName;
+    }
+    options.formatCode = query.value("selected_format_code").toString().trimmed();
+    options.downloadArchive = DownloadArchive::pathFor(query.value("url").toString());
+    DownloadArchive::createDirectory(options.downloadArchive);
+    return queueJob(query.value("url").toString(), options);
+}
+
+bool HeadlessRunner::queueUrl(const QString &url, const QString &outputDir) {
+    DownloadOptions options;
+    options.outputDir = outputDir;
+    return queueJob(url, options);
+}
+
+void HeadlessRunner::setMaxWorkers(int count) {
+    queue->setMaxWorkers(count);
+    workerPool->setMaxWorkers(count);
+}
+
+void HeadlessRunner::setUsePythonWorkers(bool use) {
+    workerPool->setEnabled(use);
+    workerPool->warmUp();
+}
+
+bool HeadlessRunner::hasJobs() const {
+    return queuedJobs > 0;
+}
+
+void HeadlessRunner::setCookiesFromBrowser(const QString &browser) {
+    cookiesFromBrowser = browser.trimmed();
+}
+
+bool HeadlessRunner::queueJob(const QString &url, const DownloadOptions &jobOptions) {
+    DownloadOptions options = jobOptions;
+    options.cookiesFromBrowser = cookiesFromBrowser;
+    QString finalOutputDir = options.finalOutputDir();
+    if (!QDir(finalOutputDir).exists() && !QDir().mkpath(finalOutputDir)) {
+        err() << "Error: Couldn't create the output directory " << finalOutputDir << Qt::endl;
+        return false;
+    }
+    int id = queue->enqueue(url, DownloadOptionsSnapshot::create(options), QStringList() << url);
+    queuedJobs++;
+    out() << QString("Queued download #%1: %2 -> %3").arg(id).arg(url, finalOutputDir) << Qt::endl;
+    return true;
+}
+
+void HeadlessRunner::onJobFinished(int id) {
+    DownloadJob job = queue->job(id);
+    if (job.state == DownloadJob::State::Finished) {
+        out() << QString("[#%1] Download finished.").arg(id) << Qt::endl;
+    } else {
+        failedJobs++;
+        err() << QString("[#%1] Download failed: %2").arg(id).arg(job.statusText) << Qt::endl;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QStringList>
+#include "downloadqueue.h"
+#include "downloadoptions.h"
+#include "workerpool.h"
+#include "helperprocesses.h"
+#include "cookiemanager.h"
+
+// YTDLPFrontend --headless: downloads bookmarks and/or URLs from the
+// command line through the same argument builder and queue as the GUI,
+// without creating a single widget. Meant for cron and servers.
+class HeadlessRunner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(QObject *parent = nullptr);
+
+    // Sets up a QCoreApplication, parses the command line and runs until the queue is done
+    static int run(int argc, char *argv[]);
+
+    bool queueBookmark(const QString &name, const QString &fallbackOutputDir);
+    bool queueUrl(const QString &url, const QString &outputDir);
+    void setMaxWorkers(int count);
+    void setUsePythonWorkers(bool use);
+    // browser[:profile], applied to every download queued afterwards
+    void setCookiesFromBrowser(const QString &browser);
+    bool hasJobs() const;
+
+signals:
+    void finished(int exitCode);
+
+private:
+    bool queueJob(const QString &url, const DownloadOptions &options);
+    void onJobFinished(int id);
+
+    DownloadQueue *queue;
+    WorkerPool *workerPool;
+    HelperProcessRegistry *helperProcesses;
+    CookieManager *cookieManager;
+    QString cookiesFromBrowser;
+    int queuedJobs = 0;
+    int failedJobs = 0;
+    // Bookmarks and URLs from the command line that never made it into the queue
+    int queueFailures = 0;
+};
+
+#endif // HEADLESSRUNNER_H
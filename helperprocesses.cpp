@@ -0,0 +1,145 @@
+#include "helperprocesses.h"
+#include <QTimer>
+#include "processreaper.h"
+#include "ytdlpcache.h"
+
+HelperProcessRegistry::HelperProcessRegistry(int maxRunning, QObject *parent) : QObject(parent), runningLimit(qMax(1, maxRunning)) {
+}
+
+HelperProcessRegistry::~HelperProcessRegistry() {
+    for (const Entry &entry : std::as_const(running)) {
+        ProcessReaper::stop(entry.process);
+    }
+}
+
+QString HelperProcessRegistry::makeKey(const QString &operation, const QStringList &args) {
+    return operation + QChar(0) + args.join(QChar(0));
+}
+
+QProcess *HelperProcessRegistry::request(const QString &operation, const QStringList &args, bool supersede, bool *existing) {
+    QProcess *process = find(operation, args);
+    if (existing) {
+        *existing = process != nullptr;
+    }
+    if (process) {
+        return process;
+    }
+    if (supersede) {
+        cancelOperation(operation);
+    }
+    Entry entry;
+    entry.operation = operation;
+    entry.key = makeKey(operation, args);
+    entry.args = args;
+    entry.process = new QProcess(this);
+    QProcess *newProcess = entry.process;
+    connect(newProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, newProcess]() {
+        onProcessDone(newProcess);
+    });
+    connect(newProcess, &QProcess::errorOccurred, this, [this, newProcess](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            onProcessDone(newProcess);
+        }
+    });
+    queued.append(entry);
+    // Start from the event loop so the caller can connect its handlers first
+    if (!scheduled) {
+        scheduled = true;
+        QTimer::singleShot(0, this, &HelperProcessRegistry::schedule);
+    }
+    return newProcess;
+}
+
+QProcess *HelperProcessRegistry::find(const QString &operation, const QStringList &args) const {
+    QString key = makeKey(operation, args);
+    for (const Entry &entry : running) {
+        if (entry.key == key) {
+            return entry.process;
+        }
+    }
+    for (const Entry &entry : queued) {
+        if (entry.key == key) {
+            return entry.process;
+        }
+    }
+    return nullptr;
+}
+
+void HelperProcessRegistry::cancel(QProcess *process) {
+    if (!process) {
+        return;
+    }
+    for (int i = 0; i < queued.size(); ++i) {
+        if (queued.at(i).process == process) {
+            queued.removeAt(i);
+            process->deleteLater();
+            return;
+        }
+    }
+    for (int i = 0; i < running.size(); ++i) {
+        if (running.at(i).process == process) {
+            running.removeAt(i);
+            // Nobody hears about a cancelled helper finishing
+            ProcessReaper::stop(process);
+            schedule();
+            return;
+        }
+    }
+}
+
+void HelperProcessRegistry::cancelOperation(const QString &operation) {
+    QList<QProcess*> superseded;
+    for (const Entry &entry : std::as_const(queued)) {
+        if (entry.operation == operation) {
+            superseded << entry.process;
+        }
+    }
+    for (const Entry &entry : std::as_const(running)) {
+        if (entry.operation == operation) {
+            superseded << entry.process;
+        }
+    }
+    for (QProcess *process : superseded) {
+        cancel(process);
+    }
+}
+
+void HelperProcessRegistry::setMaxRunning(int count) {
+    runningLimit = qMax(1, count);
+    schedule();
+}
+
+int HelperProcessRegistry::maxRunning() const {
+    return runningLimit;
+}
+
+int HelperProcessRegistry::runningCount() const {
+    return running.size();
+}
+
+int HelperProcessRegistry::queuedCount() const {
+    return queued.size();
+}
+
+void HelperProcessRegistry::schedule() {
+    scheduled = false;
+    while (running.size() < runningLimit && !queued.isEmpty()) {
+        Entry entry = queued.takeFirst();
+        running.append(entry);
+        entry.process->start("yt-dlp", YtdlpCache::args() + entry.args);
+    }
+}
+
+void HelperProcessRegistry::onProcessDone(QProcess *process) {
+    for (int i = 0; i < running.size(); ++i) {
+        if (running.at(i).process == process) {
+            running.removeAt(i);
+            break;
+        }
+    }
+    // The caller's finished handler owns the process from here and deletes it
+    if (!scheduled) {
+        scheduled = true;
+        QTimer::singleShot(0, this, &HelperProcessRegistry::schedule);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef HELPERPROCESSES_H
+#define HELPERPROCESSES_H
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+
+// Owns the short-lived yt-dlp helpers (listings, format lookups, date
+// lookups). Requests are keyed by operation + arguments: an identical
+// request gets the process that is already queued or running, a new
+// request for a superseding operation cancels the old one, and at most
+// maxRunning() helpers run at once, the rest wait in line.
+class HelperProcessRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HelperProcessRegistry(int maxRunning = 4, QObject *parent = nullptr);
+    ~HelperProcessRegistry();
+
+    // The returned process is started from the event loop, so callers can
+    // connect to it first. *existing is set when an identical request was
+    // already in flight; its signals are already connected by that caller.
+    QProcess *request(const QString &operation, const QStringList &args, bool supersede = true, bool *existing = nullptr);
+    QProcess *find(const QString &operation, const QStringList &args) const;
+    void cancel(QProcess *process);
+    void cancelOperation(const QString &operation);
+
+    void setMaxRunning(int count);
+    int maxRunning() const;
+    int runningCount() const;
+    int queuedCount() const;
+
+private:
+    struct Entry {
+        QString operation;
+        QString key;
+        QStringList args;
+        QProcess *process = nullptr;
+    };
+
+    static QString makeKey(const QString &operation, const QStringList &args);
+    void schedule();
+    void onProcessDone(QProcess *process);
+
+    QList<Entry> queued;
+    QList<Entry> running;
+    int runningLimit;
+    bool scheduled = false;
+};
+
+#endif // HELPERPROCESSES_H
@@ -0,0 +1,71 @@
+#include "infojsonstore.h"
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+
+// yt-dlp's extractor key for YouTube, part of the file name so ids from other sites can't collide
+static const char *FilePrefix = "Youtube-";
+
+QString InfoJsonStore::directory() {
+    // Created on first use, every save and lookup goes through here
+    static const QString dir = []() {
+        QString path = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/ytdlpfrontend/info-json";
+        QDir().mkpath(path);
+        return path;
+    }();
+    return dir;
+}
+
+QString InfoJsonStore::pathFor(const QString &videoId) {
+    return directory() + "/" + FilePrefix + videoId + ".info.json";
+}
+
+QString InfoJsonStore::freshPath(const QString &videoId) {
+    if (videoId.isEmpty()) {
+        return QString();
+    }
+    QFileInfo info(pathFor(videoId));
+    if (!info.exists() || info.size() == 0 || info.lastModified().secsTo(QDateTime::currentDateTime()) > MaxAgeSecs) {
+        return QString();
+    }
+    return info.filePath();
+}
+
+bool InfoJsonStore::save(const QString &videoId, const QByteArray &json) {
+    if (videoId.isEmpty() || json.isEmpty()) {
+        return false;
+    }
+    // A download reading the file never sees it half written
+    QSaveFile file(pathFor(videoId));
+    // The directory may have been cleaned up while we run
+    if (!file.open(QIODevice::WriteOnly) && !(QDir().mkpath(directory()) && file.open(QIODevice::WriteOnly))) {
+        return false;
+    }
+    file.write(json);
+    return file.commit();
+}
+
+void InfoJsonStore::remove(const QString &videoId) {
+    QFile::remove(pathFor(videoId));
+}
+
+int InfoJsonStore::prune() {
+    QDir dir(directory());
+    QDateTime now = QDateTime::currentDateTime();
+    int removed = 0;
+    const QFileInfoList files = dir.entryInfoList(QStringList() << "*.info.json", QDir::Files);
+    for (const QFileInfo &file : files) {
+        if (file.lastModified().secsTo(now) > MaxAgeSecs && QFile::remove(file.filePath())) {
+            removed++;
+        }
+    }
+    return removed;
+}
+
+QString InfoJsonStore::outputTemplate() {
+    // yt-dlp swaps the extension for .info.json itself
+    return "infojson:" + directory() + "/%(extractor_key)s-%(id)s.%(ext)s";
+}
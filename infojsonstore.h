@@ -0,0 +1,28 @@
+#ifndef INFOJSONSTORE_H
+#define INFOJSONSTORE_H
+
+#include <QString>
+#include <QByteArray>
+
+// Info JSON left over from earlier lookups (format listings, queue title
+// prefetch), one file per YouTube video id under the cache directory.
+// Downloads start from it with --load-info-json instead of extracting the
+// video again. The stream URLs inside expire after a few hours, so files
+// older than MaxAgeSecs count as missing.
+class InfoJsonStore {
+public:
+    static constexpr int MaxAgeSecs = 3 * 60 * 60;
+
+    static QString directory();
+    static QString pathFor(const QString &videoId);
+    // Empty when there's no usable file for the video
+    static QString freshPath(const QString &videoId);
+    static bool save(const QString &videoId, const QByteArray &json);
+    static void remove(const QString &videoId);
+    // Deletes expired files, returns how many
+    static int prune();
+    // yt-dlp -o template writing info JSON where pathFor() looks for it
+    static QString outputTemplate();
+};
+
+#endif // INFOJSONSTORE_H
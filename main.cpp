@@ -1,8 +1,15 @@
 #include "mainwindow.h"
+#include "headlessrunner.h"
 #include <QApplication>
 #include <QIcon>
 
 int main(int argc, char *argv[]) {
+    // Headless runs never create a QApplication, so they work without a display
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0) {
+            return HeadlessRunner::run(argc, argv);
+        }
+    }
     QApplication app(argc, argv);
     app.setWindowIcon(QIcon("/usr/share/icons/YTDLPFrontend.png"));
     MainWindow window;
@@ -13,13 +13,20 @@
 #include <QFileDialog>
 #include <QDir>
 #include <QStandardPaths>
-#include <QRegularExpression>
-#include <QThread>
 #include <QGuiApplication>
 #include <QScreen>
 #include <QTimer>
 #include <QFile>
 #include <QMessageBox>
+#include <QSpinBox>
+#include <QMenu>
+#include <QPainter>
+#include <QApplication>
+#include <QLocale>
+#include <QListView>
+#include <QScrollBar>
+#include "infojsonstore.h"
+#include "ytdlpcache.h"
 
 BookmarkDialog::BookmarkDialog(const QString& url, const QString& name, const QString& outputDir,
                                const QString& filenameFormat, const QString& outputDirFormat,
@@ -122,10 +129,73 @@ QString BookmarkDialog::getSelectedFormatCode() const {
     return selectedFormatCodeEdit->text().trimmed();
 }
 
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), process(nullptr), urlFetchProcess(nullptr) {
+void ProgressBarDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
+    QStyleOptionProgressBar progressOption;
+    progressOption.rect = option.rect.adjusted(1, 1, -1, -1);
+    progressOption.minimum = 0;
+    progressOption.maximum = 100;
+    progressOption.progress = index.data(Qt::UserRole).toInt();
+    progressOption.text = index.data(Qt::DisplayRole).toString();
+    progressOption.textVisible = true;
+    progressOption.state = option.state | QStyle::State_Horizontal;
+    QStyle *style = option.widget ? option.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ProgressBar, &progressOption, painter, option.widget);
+}
+
+SortableTableItem::SortableTableItem(const QString &text, double sortKey) : QTableWidgetItem(text) {
+    setData(Qt::UserRole, sortKey);
+}
+
+bool SortableTableItem::operator<(const QTableWidgetItem &other) const {
+    return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+}
+
+MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), channelListProcess(nullptr) {
+    downloadQueue = new DownloadQueue(this);
+    workerPool = new WorkerPool(this);
+    workerPool->setMaxWorkers(downloadQueue->maxWorkers());
+    downloadQueue->setWorkerPool(workerPool);
+    helperProcesses = new HelperProcessRegistry(4, this);
+    metadataPrefetcher = new MetadataPrefetcher(helperProcesses, this);
+    connect(metadataPrefetcher, &MetadataPrefetcher::metadataReady, this, &MainWindow::onMetadataReady);
+    connect(metadataPrefetcher, &MetadataPrefetcher::unavailable, this, &MainWindow::onMetadataUnavailable);
+    cookieManager = new CookieManager(helperProcesses, this);
+    downloadQueue->setCookieManager(cookieManager);
+    connect(cookieManager, &CookieManager::extractionFailed, this, [this](const QString &browser, const QString &error) {
+        consoleTextEdit->append("Error: Couldn't extract cookies from " + browser + ": " + error);
+        consoleTextEdit->append("Downloads read the browser's cookies themselves for now.");
+        statusBar->showMessage("Error: Couldn't extract browser cookies, see console", 5000);
+    });
+    formatFetcher = new FormatFetcher(helperProcesses, this);
+    connect(formatFetcher, &FormatFetcher::formatsReady, this, &MainWindow::onFormatsReady);
+    connect(formatFetcher, &FormatFetcher::formatsFailed, this, &MainWindow::onFormatsFailed);
+    connect(formatFetcher, &FormatFetcher::idle, this, [this]() {
+        listFormatsButton->setEnabled(true);
+        showFormats(formatsUrlComboBox->currentData().toString());
+    });
+    queueUpdates = new UpdateCoalescer(30, this);
+    channelListBatchTimer = new QTimer(this);
+    channelListBatchTimer->setInterval(queueUpdates->frameInterval());
+    channelListBatchTimer->setSingleShot(true);
+    connect(channelListBatchTimer, &QTimer::timeout, this, &MainWindow::flushChannelListBatch);
     setupUi();
     initializeDatabase();
     loadBookmarks();
+    InfoJsonStore::prune();
+    YtdlpCache::evict();
+    connect(downloadQueue, &DownloadQueue::queueIdle, this, []() {
+        YtdlpCache::evict();
+    });
+    if (YtdlpCache::needsWarmUp()) {
+        // Gets the current player and its signature functions into the cache before the first real lookup needs them
+        QProcess *warmUpProcess = helperProcesses->request("cache-warm-up", YtdlpCache::warmUpArgs());
+        connect(warmUpProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), warmUpProcess, &QObject::deleteLater);
+        connect(warmUpProcess, &QProcess::errorOccurred, warmUpProcess, [warmUpProcess](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                warmUpProcess->deleteLater();
+            }
+        });
+    }
 
     QString defaultDir = QStandardPaths::writableLocation(QStandardPaths::DownloadLocation);
     if (defaultDir.isEmpty()) {
@@ -138,29 +208,13 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), process(nullptr),
     sleepIntervalDisplay->setText("5s");
     waitForStreamDisplay->setText("30s");
 
-    originalChannelData.clear();
-    originalPlaylistTitles.clear();
-    channelOutput.clear();
 
     updateCommandPreview();
 }
 
 MainWindow::~MainWindow() {
-    if (process) {
-        if (process->state() == QProcess::Running) {
-            process->kill();
-            process->waitForFinished(1000);
-        }
-        delete process;
-        process = nullptr;
-    }
-    if (urlFetchProcess) {
-        if (urlFetchProcess->state() == QProcess::Running) {
-            urlFetchProcess->kill();
-            urlFetchProcess->waitForFinished(1000);
-        }
-        delete urlFetchProcess;
-        urlFetchProcess = nullptr;
+    if (channelListProcess) {
+        channelListProcess->disconnect();
     }
     QSqlDatabase::database().close();
     QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
@@ -197,6 +251,7 @@ void MainWindow::setupUi() {
     outputDirTextBox->setMinimumWidth(500);
     outputDirTextBox->setFixedHeight(20);
     outputDirTextBox->setContentsMargins(0, 0, 0, 0);
+    connect(outputDirTextBox, &QLineEdit::textChanged, this, &MainWindow::updateCommandPreview);
     outputLayout->addWidget(outputDirTextBox);
     selectFolderButton = new QPushButton("Select Folder");
     selectFolderButton->setFixedHeight(20);
@@ -876,20 +931,65 @@ void MainWindow::setupUi() {
     listFormatsLayout->setSpacing(4);
     listFormatsLayout->setContentsMargins(5, 5, 5, 5);
 
+    QHBoxLayout *formatsControlsLayout = new QHBoxLayout;
     listFormatsButton = new QPushButton("List Formats");
     connect(listFormatsButton, &QPushButton::clicked, this, &MainWindow::onListFormatsClicked);
-    listFormatsLayout->addWidget(listFormatsButton);
-
-    formatsTextEdit = new QTextEdit;
-    formatsTextEdit->setReadOnly(true);
-    formatsTextEdit->setFontFamily("sans-serif");
-    listFormatsLayout->addWidget(formatsTextEdit);
+    formatsControlsLayout->addWidget(listFormatsButton);
+    formatsUrlComboBox = new QComboBox;
+    formatsUrlComboBox->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    connect(formatsUrlComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int index) {
+        showFormats(formatsUrlComboBox->itemData(index).toString());
+    });
+    formatsControlsLayout->addWidget(formatsUrlComboBox, 1);
+    refreshFormatsButton = new QPushButton("Refresh");
+    refreshFormatsButton->setToolTip("Look up the formats of the selected URL again instead of using the cached list");
+    connect(refreshFormatsButton, &QPushButton::clicked, [this]() {
+        QString url = formatsUrlComboBox->currentData().toString();
+        if (url.isEmpty()) {
+            return;
+        }
+        formatErrors.remove(url);
+        listFormatsButton->setEnabled(false);
+        formatFetcher->request(QStringList() << url, true);
+        showFormats(url);
+    });
+    formatsControlsLayout->addWidget(refreshFormatsButton);
+    listFormatsLayout->addLayout(formatsControlsLayout);
+
+    formatsStatusLabel = new QLabel;
+    listFormatsLayout->addWidget(formatsStatusLabel);
+
+    formatsTable = new QTableWidget;
+    formatsTable->setColumnCount(8);
+    formatsTable->setHorizontalHeaderLabels(QStringList() << "ID" << "Ext" << "Resolution" << "FPS" << "Codec" << "TBR" << "Filesize" << "Note");
+    formatsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    formatsTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    formatsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    formatsTable->setToolTip("Double-click a format to use it, ctrl + double-click adds it to the selected format code");
+    formatsTable->verticalHeader()->hide();
+    formatsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    formatsTable->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Stretch);
+    // Best video first, audio only formats at the bottom
+    formatsTable->horizontalHeader()->setSortIndicator(2, Qt::DescendingOrder);
+    formatsTable->setSortingEnabled(true);
+    connect(formatsTable, &QTableWidget::cellDoubleClicked, [this](int row) {
+        QString formatId = formatsTable->item(row, 0)->text();
+        useQuickFormatsCheck->setChecked(false);
+        QString current = selectedFormatCodeTextBox->text().trimmed();
+        if ((QGuiApplication::keyboardModifiers() & Qt::ControlModifier) && !current.isEmpty()) {
+            selectedFormatCodeTextBox->setText(current + "+" + formatId);
+        } else {
+            selectedFormatCodeTextBox->setText(formatId);
+        }
+    });
+    listFormatsLayout->addWidget(formatsTable);
 
     QHBoxLayout *formatCodeLayout = new QHBoxLayout;
     QLabel *formatCodeLabel = new QLabel("Selected Format Code:");
     formatCodeLayout->addWidget(formatCodeLabel);
     selectedFormatCodeTextBox = new QLineEdit;
     selectedFormatCodeTextBox->setPlaceholderText("example: bestvideo+bestaudio");
+    connect(selectedFormatCodeTextBox, &QLineEdit::textChanged, this, &MainWindow::updateCommandPreview);
     formatCodeLayout->addWidget(selectedFormatCodeTextBox);
     QLabel *formatCodeInfo = new QLabel("example: 22 or 137+140 or 137,140");
     formatCodeLayout->addWidget(formatCodeInfo);
@@ -956,21 +1056,36 @@ void MainWindow::setupUi() {
     playlistClearSearchButton->setFixedHeight(20);
     playlistSearchLayout->addWidget(playlistClearSearchButton);
     playlistLayout->addLayout(playlistSearchLayout);
-    connect(playlistSearchTextBox, &QLineEdit::textChanged, this, &MainWindow::onPlaylistSearchTextChanged);
+    // Filter once typing pauses instead of on every key
+    playlistSearchTimer = new QTimer(this);
+    playlistSearchTimer->setSingleShot(true);
+    playlistSearchTimer->setInterval(150);
+    connect(playlistSearchTextBox, &QLineEdit::textChanged, playlistSearchTimer, QOverload<>::of(&QTimer::start));
+    connect(playlistSearchTimer, &QTimer::timeout, [this]() {
+        onPlaylistSearchTextChanged(playlistSearchTextBox->text());
+    });
     connect(playlistClearSearchButton, &QPushButton::clicked, playlistSearchTextBox, &QLineEdit::clear);
 
     // The list
-    playlistListWidget = new QListWidget;
+    playlistModel = new VideoListModel(this);
+    playlistFilterModel = new VideoFilterModel(playlistModel, this);
+    playlistListView = new QListView;
     QFont font;
     font.setFamily("sans-serif");
     font.setStyleHint(QFont::SansSerif);
-    playlistListWidget->setFont(font);
-    playlistLayout->addWidget(playlistListWidget);
+    playlistListView->setFont(font);
+    playlistListView->setUniformItemSizes(true);
+    playlistListView->setModel(playlistFilterModel);
+    playlistLayout->addWidget(playlistListView);
+    playlistStatusLabel = new QLabel;
+    playlistStatusLabel->setFixedHeight(20);
+    playlistLayout->addWidget(playlistStatusLabel);
 
     // Checkbox for using selected items
     useSelectedItemsCheck = new QCheckBox("Use selected items for download");
     useSelectedItemsCheck->setToolTip("Download only the selected items from the playlist");
     connect(useSelectedItemsCheck, &QCheckBox::toggled, this, &MainWindow::updateCommandPreview);
+    connect(playlistModel, &VideoListModel::checkStateChanged, this, &MainWindow::updateCommandPreview);
     playlistLayout->addWidget(useSelectedItemsCheck);
 
     // Select All, Deselect All, and List Videos buttons
@@ -987,20 +1102,10 @@ void MainWindow::setupUi() {
     playlistLayout->addLayout(selectButtonsLayout);
 
     connect(selectAllButton, &QPushButton::clicked, [this]() {
-        for (int i = 0; i < playlistListWidget->count(); ++i) {
-            QListWidgetItem *item = playlistListWidget->item(i);
-            if (item->flags() & Qt::ItemIsUserCheckable) {
-                item->setCheckState(Qt::Checked);
-            }
-        }
+        playlistFilterModel->setVisibleChecked(true);
     });
     connect(deselectAllButton, &QPushButton::clicked, [this]() {
-        for (int i = 0; i < playlistListWidget->count(); ++i) {
-            QListWidgetItem *item = playlistListWidget->item(i);
-            if (item->flags() & Qt::ItemIsUserCheckable) {
-                item->setCheckState(Qt::Unchecked);
-            }
-        }
+        playlistFilterModel->setVisibleChecked(false);
     });
 
     playlistLayout->addStretch();
@@ -1025,14 +1130,39 @@ void MainWindow::setupUi() {
     channelClearSearchButton->setFixedHeight(20);
     channelSearchLayout->addWidget(channelClearSearchButton);
     channelBrowserLayout->addLayout(channelSearchLayout);
-    connect(channelSearchTextBox, &QLineEdit::textChanged, this, &MainWindow::onChannelSearchTextChanged);
+    channelSearchTimer = new QTimer(this);
+    channelSearchTimer->setSingleShot(true);
+    channelSearchTimer->setInterval(150);
+    connect(channelSearchTextBox, &QLineEdit::textChanged, channelSearchTimer, QOverload<>::of(&QTimer::start));
+    connect(channelSearchTimer, &QTimer::timeout, [this]() {
+        onChannelSearchTextChanged(channelSearchTextBox->text());
+    });
     connect(channelClearSearchButton, &QPushButton::clicked, channelSearchTextBox, &QLineEdit::clear);
 
     // The one true list
-    channelListWidget = new QListWidget;
-    channelListWidget->setFont(font);
-    connect(channelListWidget, &QListWidget::itemChanged, this, &MainWindow::updateUseSelectedChannelCheck);
-    channelBrowserLayout->addWidget(channelListWidget);
+    channelModel = new VideoListModel(this);
+    channelFilterModel = new VideoFilterModel(channelModel, this);
+    channelListView = new QListView;
+    channelListView->setFont(font);
+    channelListView->setUniformItemSizes(true);
+    channelListView->setModel(channelFilterModel);
+    connect(channelModel, &VideoListModel::checkStateChanged, this, &MainWindow::updateUseSelectedChannelCheck);
+    channelBrowserLayout->addWidget(channelListView);
+
+    // Exact upload dates only for what is on screen or checked, looked up shortly after things settle
+    dateResolver = new UploadDateResolver(helperProcesses, this);
+    connect(dateResolver, &UploadDateResolver::dateResolved, this, &MainWindow::onUploadDateResolved);
+    dateResolveTimer = new QTimer(this);
+    dateResolveTimer->setSingleShot(true);
+    dateResolveTimer->setInterval(250);
+    connect(dateResolveTimer, &QTimer::timeout, this, &MainWindow::resolveVisibleDates);
+    connect(channelListView->verticalScrollBar(), &QScrollBar::valueChanged, dateResolveTimer, QOverload<>::of(&QTimer::start));
+    connect(channelFilterModel, &QAbstractItemModel::rowsInserted, dateResolveTimer, QOverload<>::of(&QTimer::start));
+    connect(channelFilterModel, &QAbstractItemModel::modelReset, dateResolveTimer, QOverload<>::of(&QTimer::start));
+    connect(channelModel, &VideoListModel::checkStateChanged, dateResolveTimer, QOverload<>::of(&QTimer::start));
+    channelStatusLabel = new QLabel;
+    channelStatusLabel->setFixedHeight(20);
+    channelBrowserLayout->addWidget(channelStatusLabel);
 
     // Content type dropdown
     QHBoxLayout *contentTypeLayout = new QHBoxLayout;
@@ -1070,14 +1200,23 @@ void MainWindow::setupUi() {
     channelBrowserLayout->addWidget(useSelectedChannelItemsCheck);
 
     // New checkbox for showing upload dates
-    showUploadDatesCheck = new QCheckBox("Show upload dates (much slower listing)");
+    showUploadDatesCheck = new QCheckBox("Show upload dates");
     showUploadDatesCheck->setChecked(false);
-    showUploadDatesCheck->setToolTip("Enable to include upload dates in the list, but listing will be drastically slower due to yt-dlp processing. ~4 minutes for 100 vs ~2 seconds without dates");
+    showUploadDatesCheck->setToolTip("Show approximate upload dates (marked with ~) from the listing itself. Exact dates are looked up in the background for the videos on screen and the checked ones");
     channelBrowserLayout->addWidget(showUploadDatesCheck);
-    connect(showUploadDatesCheck, &QCheckBox::toggled, this, &MainWindow::onListChannelClicked);
+    connect(showUploadDatesCheck, &QCheckBox::toggled, [this](bool checked) {
+        channelListHasDates = checked;
+        channelModel->setShowDates(checked);
+        dateResolveTimer->start();
+    });
 
-    connect(channelContentComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onListChannelClicked);
-    connect(listLimitComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onListChannelClicked);
+    // Settings and bookmark changes list after a short pause, so flicking through them starts nothing
+    channelListTimer = new QTimer(this);
+    channelListTimer->setSingleShot(true);
+    channelListTimer->setInterval(400);
+    connect(channelListTimer, &QTimer::timeout, this, &MainWindow::onListChannelClicked);
+    connect(channelContentComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::scheduleChannelListing);
+    connect(listLimitComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::scheduleChannelListing);
 
     // Select All, Deselect All, and List Videos buttons
     QHBoxLayout *channelSelectButtonsLayout = new QHBoxLayout;
@@ -1086,9 +1225,17 @@ void MainWindow::setupUi() {
     listChannelButton = new QPushButton("List Videos");
     listChannelButton->setToolTip("List titles of videos, shorts, or streams in the channel");
     connect(listChannelButton, &QPushButton::clicked, this, &MainWindow::onListChannelClicked);
+    stopListChannelButton = new QPushButton("Stop");
+    stopListChannelButton->setToolTip("Stop the channel listing that is running");
+    stopListChannelButton->setEnabled(false);
+    connect(stopListChannelButton, &QPushButton::clicked, [this]() {
+        stopChannelListing();
+        setListStatus(channelStatusLabel, "Listing stopped.");
+    });
     channelSelectButtonsLayout->addWidget(channelSelectAllButton);
     channelSelectButtonsLayout->addWidget(channelDeselectAllButton);
     channelSelectButtonsLayout->addWidget(listChannelButton);
+    channelSelectButtonsLayout->addWidget(stopListChannelButton);
     channelSelectButtonsLayout->addStretch();
     channelBrowserLayout->addLayout(channelSelectButtonsLayout);
 
@@ -1124,20 +1271,10 @@ void MainWindow::setupUi() {
     connect(bookmarksTable, &QTableWidget::itemSelectionChanged, this, &MainWindow::onBookmarkTableSelectionChanged);
 
     connect(channelSelectAllButton, &QPushButton::clicked, [this]() {
-        for (int i = 0; i < channelListWidget->count(); ++i) {
-            QListWidgetItem *item = channelListWidget->item(i);
-            if (item->flags() & Qt::ItemIsUserCheckable) {
-                item->setCheckState(Qt::Checked);
-            }
-        }
+        channelFilterModel->setVisibleChecked(true);
     });
     connect(channelDeselectAllButton, &QPushButton::clicked, [this]() {
-        for (int i = 0; i < channelListWidget->count(); ++i) {
-            QListWidgetItem *item = channelListWidget->item(i);
-            if (item->flags() & Qt::ItemIsUserCheckable) {
-                item->setCheckState(Qt::Unchecked);
-            }
-        }
+        channelFilterModel->setVisibleChecked(false);
     });
 
     channelBrowserLayout->addStretch();
@@ -1222,6 +1359,83 @@ void MainWindow::setupUi() {
     saveConfigTab->setLayout(saveConfigLayout);
     tabWidget->addTab(saveConfigTab, "Save Config");
 
+    // Download Queue Tab
+    QWidget *queueTab = new QWidget;
+    QVBoxLayout *queueLayout = new QVBoxLayout;
+    queueLayout->setSpacing(4);
+    queueLayout->setContentsMargins(5, 5, 5, 5);
+
+    QHBoxLayout *workersLayout = new QHBoxLayout;
+    QLabel *workersLabel = new QLabel("Parallel downloads:");
+    workersLayout->addWidget(workersLabel);
+    maxWorkersSpinBox = new QSpinBox;
+    maxWorkersSpinBox->setRange(1, 64);
+    maxWorkersSpinBox->setValue(downloadQueue->maxWorkers());
+    maxWorkersSpinBox->setFixedHeight(20);
+    maxWorkersSpinBox->setToolTip("How many yt-dlp processes may run at the same time. Defaults to the number of CPU cores");
+    connect(maxWorkersSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), downloadQueue, &DownloadQueue::setMaxWorkers);
+    connect(maxWorkersSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), workerPool, &WorkerPool::setMaxWorkers);
+    workersLayout->addWidget(maxWorkersSpinBox);
+    pythonWorkersCheck = new QCheckBox("Python workers");
+    pythonWorkersCheck->setToolTip("Run downloads in long-lived python processes that import yt-dlp once, instead of starting yt-dlp for every download. Needs yt-dlp installed as a python module (pip or your distro's python-yt-dlp)");
+    connect(pythonWorkersCheck, &QCheckBox::toggled, [this](bool checked) {
+        workerPool->setEnabled(checked);
+        workerPool->warmUp();
+    });
+    connect(workerPool, &WorkerPool::unavailable, this, [this](const QString &reason) {
+        consoleTextEdit->append("Error: Python workers unavailable, running yt-dlp directly: " + reason);
+        statusBar->showMessage("Python workers unavailable, see console", 5000);
+        pythonWorkersCheck->setChecked(false);
+    });
+    workersLayout->addWidget(pythonWorkersCheck);
+    workersLayout->addStretch();
+    updateStatsLabel = new QLabel("0 events, 0 frames");
+    updateStatsLabel->setToolTip("Progress and log events received from yt-dlp vs. screen updates actually made (at most 30 per second)");
+    workersLayout->addWidget(updateStatsLabel);
+    queueLayout->addLayout(workersLayout);
+
+    queueTable = new QTableWidget;
+    queueTable->setColumnCount(6);
+    queueTable->setHorizontalHeaderLabels(QStringList() << "#" << "Item" << "Status" << "Speed" << "ETA" << "Progress");
+    queueTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    queueTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    queueTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    queueTable->setContextMenuPolicy(Qt::CustomContextMenu);
+    queueTable->verticalHeader()->hide();
+    queueTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    queueTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    queueTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+    queueTable->horizontalHeader()->setSectionResizeMode(3, QHeaderView::ResizeToContents);
+    queueTable->horizontalHeader()->setSectionResizeMode(4, QHeaderView::ResizeToContents);
+    queueTable->setColumnWidth(5, 200);
+    queueTable->setItemDelegateForColumn(5, new ProgressBarDelegate(queueTable));
+    connect(queueTable, &QTableWidget::customContextMenuRequested, this, &MainWindow::onQueueContextMenuRequested);
+    queueLayout->addWidget(queueTable);
+
+    QHBoxLayout *queueButtonsLayout = new QHBoxLayout;
+    QPushButton *cancelSelectedJobsButton = new QPushButton("Cancel Selected");
+    QPushButton *retrySelectedJobsButton = new QPushButton("Retry Selected");
+    QPushButton *clearFinishedJobsButton = new QPushButton("Clear Finished");
+    connect(cancelSelectedJobsButton, &QPushButton::clicked, this, &MainWindow::onCancelSelectedJobsClicked);
+    connect(retrySelectedJobsButton, &QPushButton::clicked, this, &MainWindow::onRetrySelectedJobsClicked);
+    connect(clearFinishedJobsButton, &QPushButton::clicked, downloadQueue, &DownloadQueue::removeFinished);
+    queueButtonsLayout->addWidget(cancelSelectedJobsButton);
+    queueButtonsLayout->addWidget(retrySelectedJobsButton);
+    queueButtonsLayout->addWidget(clearFinishedJobsButton);
+    queueButtonsLayout->addStretch();
+    queueLayout->addLayout(queueButtonsLayout);
+
+    connect(downloadQueue, &DownloadQueue::jobAdded, this, &MainWindow::onQueueJobAdded);
+    connect(downloadQueue, &DownloadQueue::jobChanged, queueUpdates, &UpdateCoalescer::markDirty);
+    connect(queueUpdates, &UpdateCoalescer::frame, this, &MainWindow::onQueueFrame);
+    connect(downloadQueue, &DownloadQueue::jobFinished, this, &MainWindow::onQueueJobFinished);
+    connect(downloadQueue, &DownloadQueue::jobRemoved, this, &MainWindow::onQueueJobRemoved);
+    connect(downloadQueue, &DownloadQueue::jobOutput, this, &MainWindow::onQueueJobOutput);
+    connect(downloadQueue, &DownloadQueue::queueIdle, this, &MainWindow::downloadFinished);
+
+    queueTab->setLayout(queueLayout);
+    tabWidget->addTab(queueTab, "Downloads");
+
     // Console Tab
     QWidget *consoleTab = new QWidget;
     QVBoxLayout *consoleLayout = new QVBoxLayout;
@@ -1234,12 +1448,34 @@ void MainWindow::setupUi() {
     commandPreviewTextBox->setStyleSheet("QLineEdit { background-color: #333333; color: #ffffff; border: 1px solid #555555; padding: 2px; }");
     consoleLayout->addWidget(commandPreviewTextBox);
 
-    consoleTextEdit = new QTextEdit;
-    consoleTextEdit->setReadOnly(true);
-    consoleTextEdit->setFontFamily("sans-serif");
+    consoleTextEdit = new ConsoleView;
+    QFont consoleFont;
+    consoleFont.setFamily("sans-serif");
+    consoleFont.setStyleHint(QFont::SansSerif);
+    consoleTextEdit->setFont(consoleFont);
     consoleTextEdit->setContentsMargins(0, 0, 0, 0);
+    consoleTextEdit->setFlushInterval(queueUpdates->frameInterval());
     consoleLayout->addWidget(consoleTextEdit);
 
+    QHBoxLayout *consoleOptionsLayout = new QHBoxLayout;
+    QLabel *consoleMaxLinesLabel = new QLabel("Keep last:");
+    consoleOptionsLayout->addWidget(consoleMaxLinesLabel);
+    consoleMaxLinesSpinBox = new QSpinBox;
+    consoleMaxLinesSpinBox->setRange(1000, 1000000);
+    consoleMaxLinesSpinBox->setSingleStep(1000);
+    consoleMaxLinesSpinBox->setValue(consoleTextEdit->maxLines());
+    consoleMaxLinesSpinBox->setSuffix(" lines");
+    consoleMaxLinesSpinBox->setFixedHeight(20);
+    consoleMaxLinesSpinBox->setToolTip("Older console lines are dropped once this many are kept");
+    connect(consoleMaxLinesSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), consoleTextEdit, &ConsoleView::setMaxLines);
+    consoleOptionsLayout->addWidget(consoleMaxLinesSpinBox);
+    QPushButton *clearConsoleButton = new QPushButton("Clear");
+    clearConsoleButton->setFixedHeight(20);
+    connect(clearConsoleButton, &QPushButton::clicked, consoleTextEdit, &ConsoleView::clearLog);
+    consoleOptionsLayout->addWidget(clearConsoleButton);
+    consoleOptionsLayout->addStretch();
+    consoleLayout->addLayout(consoleOptionsLayout);
+
     consoleTab->setLayout(consoleLayout);
     tabWidget->addTab(consoleTab, "Console");
 
@@ -1251,6 +1487,7 @@ void MainWindow::setupUi() {
     buttonLayout->setContentsMargins(0, 0, 0, 0);
     buttonLayout->addStretch();
     cancelButton = new QPushButton("Cancel");
+    cancelButton->setToolTip("Cancel every queued and running download");
     cancelButton->setVisible(false);
     cancelButton->setFixedHeight(20);
     cancelButton->setContentsMargins(0, 0, 0, 0);
@@ -1261,6 +1498,12 @@ void MainWindow::setupUi() {
     downloadButton->setContentsMargins(0, 0, 0, 0);
     connect(downloadButton, &QPushButton::clicked, this, &MainWindow::onDownloadClicked);
     buttonLayout->addWidget(downloadButton);
+    QPushButton *importUrlsButton = new QPushButton("Import URLs...");
+    importUrlsButton->setFixedHeight(20);
+    importUrlsButton->setContentsMargins(0, 0, 0, 0);
+    importUrlsButton->setToolTip("Queue every URL in a text file (one per line) as its own download");
+    connect(importUrlsButton, &QPushButton::clicked, this, &MainWindow::onImportUrlsClicked);
+    buttonLayout->addWidget(importUrlsButton);
     mainLayout->addLayout(buttonLayout);
 
     // Progress bar
@@ -1358,6 +1601,10 @@ void MainWindow::initializeDatabase() {
                 consoleTextEdit->append(QString("Added %1 column to bookmarks table.").arg(it.key()));
             }
         }
+        QString cacheError;
+        if (!ChannelCache::initialize(&cacheError)) {
+            consoleTextEdit->append("Error: Couldn't create channel cache tables: " + cacheError);
+        }
         consoleTextEdit->append("Bookmark database initialized at: " + dbPath);
 }
 
@@ -1377,6 +1624,7 @@ void MainWindow::loadBookmarks() {
         return;
     }
     QMap<QString, QMap<QString, QVariant>> bookmarks;
+    bookmarkUrls.clear();
     while (query.next()) {
         QString name = query.value("name").toString();
         QMap<QString, QVariant> bookmarkData;
@@ -1389,6 +1637,7 @@ void MainWindow::loadBookmarks() {
         bookmarkData["list_limit"] = query.value("list_limit").toString();
         bookmarkData["selected_format_code"] = query.value("selected_format_code").toString();
         bookmarks.insert(name, bookmarkData);
+        bookmarkUrls.insert(bookmarkData["url"].toString());
     }
     bookmarksTable->setRowCount(bookmarks.size());
     bookmarksTable->setColumnCount(8);
@@ -1419,6 +1668,8 @@ void MainWindow::loadBookmarks() {
     }
     consoleTextEdit->append("Loaded " + QString::number(bookmarksTable->rowCount()) + " bookmarks.");
     bookmarksTable->resizeColumnsToContents();
+    // Whether the URL box is a bookmark decides the download archive
+    updateCommandPreview();
 }
 
 void MainWindow::onBookmarkClicked() {
@@ -1428,12 +1679,8 @@ void MainWindow::onBookmarkClicked() {
         QMessageBox::warning(this, "Empty URL", "Please enter a channel URL.");
         return;
     }
-    QRegularExpression channelPathRegex(
-        "^(https?://(?:(?:www|m)\\.)?youtube\\.(?:com|co\\.[a-zA-Z]{2})/(?:(?:c/|channel/|user/|@[a-zA-Z0-9_.-]+)(?:/|$)))",
-                                        QRegularExpression::CaseInsensitiveOption
-    );
-    QRegularExpressionMatch match = channelPathRegex.match(url);
-    if (!match.hasMatch()) {
+    UrlInfo urlInfo = UrlClassifier::classify(url);
+    if (!urlInfo.isChannel()) {
         consoleTextEdit->append("Invalid channel URL");
         QMessageBox::warning(this, "Invalid URL",
                              "Please enter a valid YouTube channel URL.\n\n"
@@ -1444,17 +1691,8 @@ void MainWindow::onBookmarkClicked() {
                              "- https://www.youtube.com/user/Username");
         return;
     }
-    QString normalizedUrl = match.captured(1);
-    if (normalizedUrl.endsWith('/')) {
-        normalizedUrl = normalizedUrl.left(normalizedUrl.length() - 1);
-    }
-
-    QString channelName;
-    QStringList parts = normalizedUrl.split('/');
-    channelName = parts.last();
-    if (channelName.startsWith('@')) {
-        channelName = channelName.mid(1);
-    }
+    QString normalizedUrl = urlInfo.channelBase;
+    QString channelName = urlInfo.channelName();
 
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
@@ -1671,7 +1909,7 @@ void MainWindow::onBookmarkTableSelectionChanged() {
         consoleTextEdit->append(message);
         statusBar->showMessage("Selected bookmark: " + query.value("name").toString(), 5000);
         updateCommandPreview();
-        onListChannelClicked();
+        scheduleChannelListing();
     } else {
         consoleTextEdit->append("Error retrieving bookmark: " + query.lastError().text());
         QMessageBox::warning(this, "Database Error", "Failed to retrieve bookmark: " + query.lastError().text());
@@ -1722,193 +1960,247 @@ void MainWindow::onSelectFolderClicked() {
     }
 }
 
-void MainWindow::onDownloadClicked() {
-    if (urlTextBox->text().trimmed().isEmpty()) {
-        consoleTextEdit->append("Please enter at least one URL");
-        statusBar->showMessage("Please enter at least one URL", 5000);
-        return;
+QString MainWindow::finalOutputDirectory() const {
+    QString outputDir = outputDirTextBox->text().trimmed();
+    if (useOutputSubdirCheck->isChecked()) {
+        QString subdirName = outputSubdirTextBox->text().trimmed();
+        if (subdirName.isEmpty()) {
+            subdirName = "yt-dlp output";
+        }
+        outputDir = QDir(outputDir).filePath(subdirName);
     }
+    return outputDir;
+}
+
+bool MainWindow::prepareOutputDirectory() {
     QString outputDir = outputDirTextBox->text().trimmed();
     if (outputDir.isEmpty()) {
         consoleTextEdit->append("Please select an output directory");
         statusBar->showMessage("Please select an output directory", 5000);
-        return;
+        return false;
     }
     if (!QFileInfo(outputDir).exists()) {
         consoleTextEdit->append("Error: The specified output directory does not exist!");
         statusBar->showMessage("Error: Output directory does not exist!", 5000);
-        return;
-    }
-    QString finalOutputDir = outputDir;
-    if (useOutputSubdirCheck->isChecked()) {
-        QString subdirName = outputSubdirTextBox->text().trimmed();
-        if (subdirName.isEmpty()) {
-            subdirName = "yt-dlp output";
-        }
-        finalOutputDir = QDir(outputDir).filePath(subdirName);
+        return false;
     }
+    QString finalOutputDir = finalOutputDirectory();
     QDir dir(finalOutputDir);
     if (!dir.exists()) {
         if (!dir.mkpath(".")) {
             consoleTextEdit->append("Error: Couldn't create the base output directory!");
             statusBar->showMessage("Error: Couldn't create the output directory!", 5000);
-            return;
+            return false;
         }
     }
     if (!QFileInfo(finalOutputDir).isWritable()) {
         consoleTextEdit->append("Error: You don't have permission to write to this directory!");
         statusBar->showMessage("Error: No write permission for the output directory!", 5000);
-        return;
+        return false;
     }
     consoleTextEdit->append("Downloads will be saved to: " + finalOutputDir);
-    statusBar->showMessage("Starting download to " + finalOutputDir, 5000);
-    downloadButton->setEnabled(false);
-    cancelButton->setVisible(true);
-    progressBar->setValue(0);
-    progressBar->setVisible(true);
-    consoleTextEdit->append("Starting download...");
-    downloadStartTime = QDateTime::currentDateTime();
-    filesToDelete.clear();
-
-    QStringList channelPathRegexList;
-    channelPathRegexList << "^(https?://(?:(?:www|m)\\.)?youtube\\.(?:com|co\\.[a-zA-Z]{2})/(?:(?:c/|channel/|user/|@[a-zA-Z0-9_.-]+)(?:/|$)))";
-    QRegularExpression channelPathRegex(channelPathRegexList.join('|'), QRegularExpression::CaseInsensitiveOption);
-    QRegularExpression playlistRegex(
-        "^https?://(?:(?:www|m)\\.)?youtube\\.(?:com|co\\.[a-zA-Z]{2})/(?:playlist\\?list=[a-zA-Z0-9_.-]+|watch\\?v=[a-zA-Z0-9_.-]+&list=[a-zA-Z0-9_.-]+.*)$",
-                                     QRegularExpression::CaseInsensitiveOption
-    );
-    bool isChannelUrl = channelPathRegex.match(urlTextBox->text().trimmed()).hasMatch();
-    bool isPlaylistUrl = playlistRegex.match(urlTextBox->text().trimmed()).hasMatch();
+    return true;
+}
+
+void MainWindow::onDownloadClicked() {
+    if (urlTextBox->text().trimmed().isEmpty()) {
+        consoleTextEdit->append("Please enter at least one URL");
+        statusBar->showMessage("Please enter at least one URL", 5000);
+        return;
+    }
+    if (!prepareOutputDirectory()) {
+        return;
+    }
+
+    UrlInfo urlInfo = UrlClassifier::classify(urlTextBox->text().split(' ', Qt::SkipEmptyParts).value(0));
+    bool isChannelUrl = urlInfo.isChannel();
+    bool isPlaylistUrl = urlInfo.isPlaylist();
     if (useSelectedItemsCheck->isChecked() && isPlaylistUrl) {
-        QList<int> selectedIndices;
-        for (int i = 0; i < playlistListWidget->count(); ++i) {
-            QListWidgetItem *item = playlistListWidget->item(i);
-            if (item->flags() & Qt::ItemIsUserCheckable && item->checkState() == Qt::Checked) {
-                int originalIndex = item->data(OriginalIndexRole).toInt();
-                if (originalIndex > 0) {
-                    selectedIndices << originalIndex;
-                }
-            }
-        }
-        if (selectedIndices.isEmpty()) {
+        if (!playlistModel->hasChecked()) {
             consoleTextEdit->append("Error: No videos selected for download.");
             statusBar->showMessage("Error: No videos selected for download.", 5000);
-            downloadButton->setEnabled(true);
-            cancelButton->setVisible(false);
-            progressBar->setVisible(false);
             return;
         }
         startDownload();
     } else if (useSelectedChannelItemsCheck->isChecked() && isChannelUrl) {
-        QList<int> selectedIndices;
-        for (int i = 0; i < channelListWidget->count(); ++i) {
-            QListWidgetItem *item = channelListWidget->item(i);
-            if (item->flags() & Qt::ItemIsUserCheckable && item->checkState() == Qt::Checked) {
-                int originalIndex = item->data(OriginalIndexRole).toInt();
-                if (originalIndex > 0) {
-                    selectedIndices << originalIndex;
-                }
-            }
-        }
-        if (selectedIndices.isEmpty()) {
+        // URLs were captured while listing, no need to ask yt-dlp again
+        QStringList videoUrls = channelModel->checkedUrls();
+        if (videoUrls.isEmpty()) {
             consoleTextEdit->append("Error: No videos selected for download.");
             statusBar->showMessage("Error: No videos selected for download.", 5000);
-            downloadButton->setEnabled(true);
-            cancelButton->setVisible(false);
-            progressBar->setVisible(false);
             return;
         }
-        QString endpoint;
-        if (channelContentComboBox->currentText() == "Videos") {
-            endpoint = "/videos";
-        } else if (channelContentComboBox->currentText() == "Shorts") {
-            endpoint = "/shorts";
-        } else if (channelContentComboBox->currentText() == "Live Streams") {
-            endpoint = "/streams";
-        }
-        QString channelUrl = channelPathRegex.match(urlTextBox->text().trimmed()).captured(1);
-        if (channelUrl.endsWith('/')) {
-            channelUrl = channelUrl.left(channelUrl.length() - 1);
-        }
-        getSelectedChannelVideoUrls(channelUrl, endpoint, selectedIndices);
+        consoleTextEdit->append(QString("Downloading %1 selected videos from the channel listing.").arg(videoUrls.size()));
+        startDownload(videoUrls);
     } else {
         startDownload();
     }
 }
 
 void MainWindow::onCancelClicked() {
-    if (process) {
-        process->kill();
-        QTimer::singleShot(1000, this, &MainWindow::onCancelCleanup);
+    downloadQueue->cancelAll();
+    statusBar->showMessage("Cancelling downloads...", 5000);
+}
+
+void MainWindow::onQueueJobAdded(int id) {
+    DownloadJob job = downloadQueue->job(id);
+    int row = queueTable->rowCount();
+    queueTable->insertRow(row);
+    QTableWidgetItem *idItem = new QTableWidgetItem(QString::number(id));
+    idItem->setData(Qt::UserRole, id);
+    queueTable->setItem(row, 0, idItem);
+    QTableWidgetItem *labelItem = new QTableWidgetItem(job.label);
+    labelItem->setToolTip("yt-dlp " + job.args.join(" "));
+    queueTable->setItem(row, 1, labelItem);
+    queueTable->setItem(row, 2, new QTableWidgetItem(job.statusText));
+    queueTable->setItem(row, 3, new QTableWidgetItem);
+    queueTable->setItem(row, 4, new QTableWidgetItem);
+    QTableWidgetItem *progressItem = new QTableWidgetItem("0%");
+    progressItem->setData(Qt::UserRole, 0);
+    queueTable->setItem(row, 5, progressItem);
+    queueItems.insert(id, idItem);
+    queueUpdates->markDirty(id);
+}
+
+void MainWindow::onQueueFrame(const QList<int> &dirtyJobs) {
+    for (int id : dirtyJobs) {
+        refreshQueueRow(id);
     }
+    updateQueueProgress();
+    updateStatsLabel->setText(QString("%1 events, %2 frames").arg(queueUpdates->eventsReceived()).arg(queueUpdates->framesPainted()));
 }
 
-void MainWindow::onCancelCleanup() {
-    for (const QString &file : filesToDelete) {
-        QFile::remove(file);
-        consoleTextEdit->append("Deleted file: " + file);
+void MainWindow::refreshQueueRow(int id) {
+    QTableWidgetItem *idItem = queueItems.value(id);
+    if (!idItem) {
+        return;
     }
-    QString outputDir = outputDirTextBox->text();
-    if (useOutputSubdirCheck->isChecked()) {
-        QString subdirName = outputSubdirTextBox->text().trimmed();
-        if (subdirName.isEmpty()) {
-            subdirName = "yt-dlp output";
-        }
-        outputDir = QDir(outputDir).filePath(subdirName);
+    DownloadJob job = downloadQueue->job(id);
+    int row = idItem->row();
+    queueTable->item(row, 1)->setText(job.label);
+    QTableWidgetItem *statusItem = queueTable->item(row, 2);
+    statusItem->setText(job.attempts > 1 ? QString("%1 (attempt %2)").arg(job.statusText).arg(job.attempts) : job.statusText);
+    if (job.state == DownloadJob::State::Failed) {
+        statusItem->setForeground(Qt::red);
+    } else if (job.state == DownloadJob::State::Cancelled || job.state == DownloadJob::State::Skipped) {
+        statusItem->setForeground(Qt::gray);
+    } else {
+        statusItem->setForeground(queueTable->palette().text());
+    }
+    bool downloading = job.state == DownloadJob::State::Downloading;
+    queueTable->item(row, 3)->setText(downloading ? job.speed : QString());
+    queueTable->item(row, 4)->setText(downloading ? job.eta : QString());
+    QString progressText = QString::number(job.progress) + "%";
+    if (downloading && job.totalBytes > 0) {
+        progressText += " of " + QLocale().formattedDataSize(job.totalBytes);
+    }
+    if (downloading && job.fragmentCount > 0) {
+        progressText += QString(" (frag %1/%2)").arg(job.fragmentIndex).arg(job.fragmentCount);
+    }
+    QTableWidgetItem *progressItem = queueTable->item(row, 5);
+    progressItem->setData(Qt::UserRole, job.progress);
+    progressItem->setText(progressText);
+}
+
+void MainWindow::onQueueJobFinished(int id) {
+    DownloadJob job = downloadQueue->job(id);
+    QString message;
+    if (job.state == DownloadJob::State::Finished) {
+        message = "Download finished.";
+    } else if (job.state == DownloadJob::State::Cancelled) {
+        message = "Download cancelled.";
+    } else if (job.state == DownloadJob::State::Skipped) {
+        message = job.statusText;
+    } else {
+        message = "Download failed: " + job.statusText;
     }
-    QDir dir(outputDir);
-    QStringList partFiles = dir.entryList(QStringList() << "*.part", QDir::Files);
-    for (const QString &partFile : partFiles) {
-        if (QFileInfo(dir.filePath(partFile)).birthTime() > downloadStartTime) {
-            QFile::remove(dir.filePath(partFile));
-            consoleTextEdit->append("Deleted file: " + partFile);
+    consoleTextEdit->append(QString("[#%1] %2").arg(id).arg(message));
+    statusBar->showMessage(QString("#%1: %2").arg(id).arg(message), 5000);
+    if (job.urls.size() == 1) {
+        prefetchJobs.remove(job.urls.first());
+    }
+    prefetchAhead();
+    if (job.options && !job.options->downloadArchive.isEmpty() && job.options->downloadArchive == channelArchive.path()) {
+        channelModel->addArchivedIds(channelArchive.refresh());
+    }
+
+    if (downloadQueue->isIdle()) {
+        int finished = 0, failed = 0, skipped = 0;
+        const QList<int> ids = downloadQueue->jobIds();
+        for (int jobId : ids) {
+            DownloadJob::State state = downloadQueue->job(jobId).state;
+            finished += state == DownloadJob::State::Finished;
+            failed += state == DownloadJob::State::Failed;
+            skipped += state == DownloadJob::State::Skipped;
+        }
+        if (ids.size() > 1) {
+            consoleTextEdit->append(QString("All downloads done: %1 finished, %2 failed, %3 skipped.").arg(finished).arg(failed).arg(skipped));
         }
     }
-    consoleTextEdit->append("Download cancelled.");
-    statusBar->showMessage("Download cancelled", 5000);
-    downloadButton->setEnabled(true);
-    cancelButton->setVisible(false);
-    progressBar->setVisible(false);
-    downloadState = DownloadState::Idle;
-}
-
-void MainWindow::onProcessOutput() {
-    QByteArray output = process->readAllStandardOutput();
-    QString outputStr = QString::fromUtf8(output);
-    consoleTextEdit->append(outputStr);
-
-    // Track downloaded files
-    if (outputStr.contains("[download] Destination:")) {
-        QString filePath = outputStr.split("[download] Destination:").last().trimmed();
-        filesToDelete.append(filePath);
-        downloadState = DownloadState::Downloading;
-    } else if (outputStr.contains("[Merger] Merging formats into")) {
-        QString filePath = outputStr.split("[Merger] Merging formats into").last().trimmed().remove('"');
-        filesToDelete.append(filePath);
-        downloadState = DownloadState::PostProcessing;
-    } else if (outputStr.contains("[sponsorblock]") || outputStr.contains("[ffmpeg]") || outputStr.contains("[Metadata]")) {
-        downloadState = DownloadState::PostProcessing;
-    }
-
-    // Update progress bar
-    if (downloadState == DownloadState::Downloading) {
-        QRegularExpression ytDlpRegex("\\[download\\]\\s*(\\d+\\.\\d+)%");
-        QRegularExpressionMatch ytDlpMatch = ytDlpRegex.match(outputStr);
-        if (ytDlpMatch.hasMatch()) {
-            double percentage = ytDlpMatch.captured(1).toDouble();
-            progressBar->setValue(static_cast<int>(percentage));
-        } else {
-            QRegularExpression aria2cRegex("\\((\\d+)%\\)");
-            QRegularExpressionMatch aria2cMatch = aria2cRegex.match(outputStr);
-            if (aria2cMatch.hasMatch()) {
-                double percentage = aria2cMatch.captured(1).toDouble();
-                progressBar->setValue(static_cast<int>(percentage));
-            }
+}
+
+void MainWindow::onQueueJobRemoved(int id) {
+    retriedJobs.remove(id);
+    QTableWidgetItem *idItem = queueItems.take(id);
+    if (idItem) {
+        queueTable->removeRow(idItem->row());
+    }
+}
+
+void MainWindow::onQueueJobOutput(int id, const QString &text) {
+    consoleTextEdit->append(QString("[#%1] %2").arg(id).arg(text));
+    queueUpdates->markEvent();
+}
+
+QList<int> MainWindow::selectedQueueJobs() const {
+    QList<int> ids;
+    const QList<QTableWidgetSelectionRange> ranges = queueTable->selectedRanges();
+    for (const QTableWidgetSelectionRange &range : ranges) {
+        for (int row = range.topRow(); row <= range.bottomRow(); ++row) {
+            ids << queueTable->item(row, 0)->data(Qt::UserRole).toInt();
         }
-    } else if (downloadState == DownloadState::PostProcessing) {
-        progressBar->setValue(100);
-        progressBar->setFormat("Post-processing...");
     }
+    return ids;
+}
+
+void MainWindow::onCancelSelectedJobsClicked() {
+    for (int id : selectedQueueJobs()) {
+        downloadQueue->cancel(id);
+    }
+}
+
+void MainWindow::onRetrySelectedJobsClicked() {
+    for (int id : selectedQueueJobs()) {
+        retriedJobs.insert(id);
+        downloadQueue->retry(id);
+    }
+}
+
+void MainWindow::onQueueContextMenuRequested(const QPoint &pos) {
+    if (!queueTable->itemAt(pos)) {
+        return;
+    }
+    QMenu menu(this);
+    QAction *cancelAction = menu.addAction("Cancel");
+    QAction *retryAction = menu.addAction("Retry");
+    QAction *chosen = menu.exec(queueTable->viewport()->mapToGlobal(pos));
+    if (chosen == cancelAction) {
+        onCancelSelectedJobsClicked();
+    } else if (chosen == retryAction) {
+        onRetrySelectedJobsClicked();
+    }
+}
+
+void MainWindow::updateQueueProgress() {
+    if (downloadQueue->isIdle()) {
+        progressBar->setVisible(false);
+        cancelButton->setVisible(false);
+        return;
+    }
+    progressBar->setVisible(true);
+    cancelButton->setVisible(true);
+    progressBar->setValue(downloadQueue->averageActiveProgress());
+    progressBar->setFormat(QString("%p% - %1 running, %2 queued").arg(downloadQueue->runningCount()).arg(downloadQueue->queuedCount()));
 }
 
 void MainWindow::onUseCookiesFileToggled(bool checked) {
@@ -1938,225 +2230,137 @@ void MainWindow::onBrowseCookiesFileClicked() {
 }
 
 void MainWindow::updateCommandPreview() {
+    // Every option widget ends up here when it changes, so this is the one place the tabs are read
+    DownloadOptions options = currentOptions(UrlClassifier::classify(urlTextBox->text().split(' ', Qt::SkipEmptyParts).value(0)));
+    if (!downloadOptions || *downloadOptions != options) {
+        downloadOptions = DownloadOptionsSnapshot::create(options);
+    }
     QStringList args = buildCommand();
     QString command = "yt-dlp " + args.join(" ");
     commandPreviewTextBox->setText(command);
 }
 
-QStringList MainWindow::buildCommand() {
-    QStringList args;
-    args << "--progress";
+DownloadOptionsSnapshot MainWindow::optionsFor(const QStringList &urlOverride) const {
+    // Selected playlist items only apply to the playlist in the URL box
+    if (urlOverride.isEmpty() || downloadOptions->playlistItems.isEmpty()) {
+        return downloadOptions;
+    }
+    DownloadOptions options = *downloadOptions;
+    options.playlistItems.clear();
+    return DownloadOptionsSnapshot::create(options);
+}
+
+QStringList MainWindow::buildCommand(const QStringList &urlOverride) {
+    QStringList urlsToDownload = urlOverride.isEmpty() ? urlTextBox->text().split(' ', Qt::SkipEmptyParts) : urlOverride;
+    return toArgs(*optionsFor(urlOverride)) + urlsToDownload;
+}
 
+DownloadOptions MainWindow::currentOptions(const UrlInfo &urlInfo) const {
+    DownloadOptions options;
     // General Options
-    if (disableConfigCheck->isChecked()) {
-        args << "--ignore-config";
-    }
-    if (continueOnErrorsCheck->isChecked()) {
-        args << "--ignore-errors";
-    }
-    if (forceGenericExtractorCheck->isChecked()) {
-        args << "--force-generic-extractor";
-    }
-    if (legacyServerConnectCheck->isChecked()) {
-        args << "--legacy-server-connect";
-    }
-    if (ignoreSslCertificateCheck->isChecked()) {
-        args << "--no-check-certificate";
-    }
-    if (embedThumbnailCheck->isChecked()) {
-        args << "--embed-thumbnail";
-    }
-    if (addMetadataCheck->isChecked()) {
-        args << "--add-metadata";
-    }
-    if (embedInfoJsonCheck->isChecked()) {
-        args << "--embed-info-json";
-    }
-    if (embedChaptersCheck->isChecked()) {
-        args << "--embed-chapters";
-    }
-    if (sleepIntervalCheck->isChecked()) {
-        args << "--sleep-interval" << QString::number(sleepIntervalSlider->value());
-    }
-    if (waitForStreamCheck->isChecked()) {
-        args << "--wait-for-video" << QString::number(waitForStreamSlider->value());
-    }
+    options.ignoreConfig = disableConfigCheck->isChecked();
+    options.continueOnErrors = continueOnErrorsCheck->isChecked();
+    options.forceGenericExtractor = forceGenericExtractorCheck->isChecked();
+    options.legacyServerConnect = legacyServerConnectCheck->isChecked();
+    options.noCheckCertificate = ignoreSslCertificateCheck->isChecked();
+    options.embedThumbnail = embedThumbnailCheck->isChecked();
+    options.addMetadata = addMetadataCheck->isChecked();
+    options.embedInfoJson = embedInfoJsonCheck->isChecked();
+    options.embedChapters = embedChaptersCheck->isChecked();
+    options.sleepInterval = sleepIntervalCheck->isChecked() ? sleepIntervalSlider->value() : 0;
+    options.waitForVideo = waitForStreamCheck->isChecked() ? waitForStreamSlider->value() : 0;
     if (impersonateCheck->isChecked()) {
-        args << "--impersonate" << impersonateComboBox->currentText();
-    }
-    // Playlist or Channel Selected Items
-    QStringList urlsToDownload = urlTextBox->text().split(' ', Qt::SkipEmptyParts);
-    if (urlsToDownload.isEmpty() && downloadState == DownloadState::Downloading) {
-        consoleTextEdit->append("Error: No URLs provided for download.");
-        return QStringList();
+        options.impersonate = impersonateComboBox->currentText();
     }
+    // Playlist Selected Items
     if (useSelectedItemsCheck->isChecked()) {
-        QRegularExpression playlistRegex(
-            "^https?://(?:(?:www|m)\\.)?youtube\\.(?:com|co\\.[a-zA-Z]{2})/(?:playlist\\?list=[a-zA-Z0-9_.-]+|watch\\?v=[a-zA-Z0-9_.-]+&list=[a-zA-Z0-9_.-]+.*)$",
-                                         QRegularExpression::CaseInsensitiveOption
-        );
-        if (!urlsToDownload.isEmpty() && playlistRegex.match(urlsToDownload.first()).hasMatch()) {
-            QList<int> selectedIndices;
-            for (int i = 0; i < playlistListWidget->count(); ++i) {
-                QListWidgetItem *item = playlistListWidget->item(i);
-                if (item->flags() & Qt::ItemIsUserCheckable && item->checkState() == Qt::Checked) {
-                    int originalIndex = item->data(OriginalIndexRole).toInt();
-                    if (originalIndex > 0) {
-                        selectedIndices << originalIndex;
-                    }
-                }
-            }
-            if (!selectedIndices.isEmpty()) {
-                QString playlistItems = generatePlaylistItems(selectedIndices);
-                args << "--playlist-items" << playlistItems;
-            }
+        if (playlistModel->hasChecked() && urlInfo.isPlaylist()) {
+            options.playlistItems = generatePlaylistItems(playlistModel->checkedSet());
         }
     }
     // Subtitles Options
-    if (downloadSubsCheck->isChecked()) {
-        args << "--write-subs";
-        if (allSubsRadio->isChecked()) {
-            args << "--sub-langs" << "all";
-        } else if (specificSubsRadio->isChecked()) {
-            QStringList selectedLangs;
-            for (int i = 0; i < subsLangList->count(); ++i) {
-                QListWidgetItem *item = subsLangList->item(i);
-                if (item->checkState() == Qt::Checked) {
-                    selectedLangs << item->text();
-                }
+    options.writeSubs = downloadSubsCheck->isChecked();
+    if (allSubsRadio->isChecked()) {
+        options.subLangs = "all";
+    } else if (specificSubsRadio->isChecked()) {
+        QStringList selectedLangs;
+        for (int i = 0; i < subsLangList->count(); ++i) {
+            QListWidgetItem *item = subsLangList->item(i);
+            if (item->checkState() == Qt::Checked) {
+                selectedLangs << item->text();
             }
-            if (!selectedLangs.isEmpty()) {
-                args << "--sub-langs" << selectedLangs.join(",");
-            }
-        }
-        if (embedSubsCheck->isChecked()) {
-            args << "--embed-subs";
         }
+        options.subLangs = selectedLangs.join(",");
     }
+    options.embedSubs = embedSubsCheck->isChecked();
     // SponsorBlock Options
-    if (enableSponsorBlockCheck->isChecked()) {
-        args << "--sponsorblock-mark" << "all";
-        QStringList removeCategories;
-        if (sponsorCheck->isChecked()) removeCategories << "sponsor";
-        if (selfPromoCheck->isChecked()) removeCategories << "selfpromo";
-        if (interactionCheck->isChecked()) removeCategories << "interaction";
-        if (fillerCheck->isChecked()) removeCategories << "filler";
-        if (outroCheck->isChecked()) removeCategories << "outro";
-        if (introCheck->isChecked()) removeCategories << "intro";
-        if (previewCheck->isChecked()) removeCategories << "preview";
-        if (musicOfftopicCheck->isChecked()) removeCategories << "music_offtopic";
-        if (!removeCategories.isEmpty()) {
-            args << "--sponsorblock-remove" << removeCategories.join(",");
-        }
-    }
+    options.sponsorBlock = enableSponsorBlockCheck->isChecked();
+    options.sponsorBlockRemove.clear();
+    if (sponsorCheck->isChecked()) options.sponsorBlockRemove << "sponsor";
+    if (selfPromoCheck->isChecked()) options.sponsorBlockRemove << "selfpromo";
+    if (interactionCheck->isChecked()) options.sponsorBlockRemove << "interaction";
+    if (fillerCheck->isChecked()) options.sponsorBlockRemove << "filler";
+    if (outroCheck->isChecked()) options.sponsorBlockRemove << "outro";
+    if (introCheck->isChecked()) options.sponsorBlockRemove << "intro";
+    if (previewCheck->isChecked()) options.sponsorBlockRemove << "preview";
+    if (musicOfftopicCheck->isChecked()) options.sponsorBlockRemove << "music_offtopic";
     // Filename Formatting Options
-    if (autoNumberCheck->isChecked()) {
-        args << "--autonumber-start" << "1";
-    }
-    if (restrictFilenamesCheck->isChecked()) {
-        args << "--restrict-filenames";
-    }
-    if (replaceSpacesCheck->isChecked()) {
-        args << "--replace-in-metadata" << "title,uploader,channel" << "\\s" << "_";
-    }
-    if (allowUnsafeExtCheck->isChecked()) {
-        args << "--compat-options" << "allow-unsafe-ext";
-    }
-    if (allowOverwritesCheck->isChecked()) {
-        args << "--force-overwrites";
-    }
-    QString customFormat = customFormatTextBox->text().trimmed();
-    if (customFormat.isEmpty()) {
-        customFormat = "%(title)s";
-    }
-    QString extension = extensionComboBox->currentText();
-    if (extension == "Default") {
-        extension = "%(ext)s";
-    } else {
-        args << "--merge-output-format" << extension;
-    }
-    QString customDirFormat = customOutputDirFormatTextBox->text().trimmed();
-    if (customDirFormat.isEmpty()) {
-        customDirFormat = outputDirFormatComboBox->currentText() == "Default" ? "" : outputDirFormatComboBox->currentText();
-    }
-    QString outputTemplate;
-    if (useOutputSubdirCheck->isChecked()) {
-        QString subdirName = outputSubdirTextBox->text().trimmed();
-        if (subdirName.isEmpty()) {
-            subdirName = "yt-dlp output";
-        }
-        if (customDirFormat.isEmpty()) {
-            outputTemplate = QDir(outputDirTextBox->text()).filePath(
-                subdirName + QDir::separator() + customFormat + "." + extension
-            );
-        } else {
-            outputTemplate = QDir(outputDirTextBox->text()).filePath(
-                subdirName + QDir::separator() +
-                customDirFormat + QDir::separator() + customFormat + "." + extension
-            );
-        }
-    } else {
-        if (customDirFormat.isEmpty()) {
-            outputTemplate = QDir(outputDirTextBox->text()).filePath(
-                customFormat + "." + extension
-            );
-        } else {
-            outputTemplate = QDir(outputDirTextBox->text()).filePath(
-                customDirFormat + QDir::separator() + customFormat + "." + extension
-            );
-        }
-    }
-    args << "--output" << outputTemplate;
-    if (trimFilenamesCheck->isChecked()) {
-        args << "--trim-filenames" << QString::number(trimLengthSlider->value());
+    options.autoNumber = autoNumberCheck->isChecked();
+    options.restrictFilenames = restrictFilenamesCheck->isChecked();
+    options.replaceSpaces = replaceSpacesCheck->isChecked();
+    options.allowUnsafeExt = allowUnsafeExtCheck->isChecked();
+    options.forceOverwrites = allowOverwritesCheck->isChecked();
+    options.filenameFormat = customFormatTextBox->text().trimmed();
+    if (extensionComboBox->currentText() != "Default") {
+        options.mergeFormat = extensionComboBox->currentText();
+    }
+    options.outputDirFormat = customOutputDirFormatTextBox->text().trimmed();
+    if (options.outputDirFormat.isEmpty() && outputDirFormatComboBox->currentText() != "Default") {
+        options.outputDirFormat = outputDirFormatComboBox->currentText();
+    }
+    options.outputDir = outputDirTextBox->text();
+    options.useSubdir = useOutputSubdirCheck->isChecked();
+    options.subdirName = outputSubdirTextBox->text().trimmed();
+    options.trimFilenames = trimFilenamesCheck->isChecked() ? trimLengthSlider->value() : 0;
+    if (urlInfo.isChannel() && bookmarkUrls.contains(urlInfo.channelBase)) {
+        options.downloadArchive = DownloadArchive::pathFor(urlInfo.channelBase);
     }
     // Authorization Options
-    if (enableAuthCheck->isChecked() && !usernameTextBox->text().isEmpty()) {
-        args << "--username" << usernameTextBox->text();
-    }
-    if (enableAuthCheck->isChecked() && !passwordTextBox->text().isEmpty()) {
-        args << "--password" << passwordTextBox->text();
+    if (enableAuthCheck->isChecked()) {
+        options.username = usernameTextBox->text();
+        options.password = passwordTextBox->text();
     }
     // Additional urls from metadata
-    if (downloadAdditionalUrlsCheck->isChecked() && !additionalUrlsRegexTextBox->text().isEmpty()) {
-        args << "--parse-metadata" << additionalUrlsRegexTextBox->text();
+    if (downloadAdditionalUrlsCheck->isChecked()) {
+        options.parseMetadata = additionalUrlsRegexTextBox->text();
     }
     // Cookie Options
     if (useCookiesFileCheck->isChecked() && !cookiesFileTextBox->text().isEmpty()) {
-        args << "--cookies" << cookiesFileTextBox->text();
+        options.cookiesFile = cookiesFileTextBox->text();
     } else if (extractCookiesFromBrowserCheck->isChecked()) {
         QString browser = browserComboBox->currentText().toLower();
         QString profile = browserProfileTextBox->text().trimmed();
         if (!profile.isEmpty()) {
             browser += ":" + profile;
         }
-        args << "--cookies-from-browser" << browser;
+        options.cookiesFromBrowser = browser;
     }
     QString selectedSection = downloadSectionsComboBox->currentText();
-    if (selectedSection != "Disable" && selectedSection != "Download entire video") {
-        QString sectionArg;
-        if (selectedSection == "Download intro chapter") {
-            sectionArg = "intro";
-        } else if (selectedSection == "Download first 5 minutes") {
-            sectionArg = "*0:00-5:00";
-        } else if (selectedSection == "Download last 5 minutes") {
-            sectionArg = "*-5:00-inf";
-        } else if (selectedSection == "Custom chapter regex") {
-            sectionArg = downloadSectionsTextBox->text().trimmed();
-        } else if (selectedSection == "Custom time range") {
-            QString timeRange = downloadSectionsTextBox->text().trimmed();
-            if (!timeRange.isEmpty()) {
-                sectionArg = "*" + timeRange;
-            }
-        }
-        if (!sectionArg.isEmpty()) {
-            args << "--download-sections" << sectionArg;
-        }
-    }
-    QString selectedFormatCode = selectedFormatCodeTextBox->text().trimmed();
-    if (!selectedFormatCode.isEmpty()) {
-        args << "-f" << selectedFormatCode;
-    }
+    if (selectedSection == "Download intro chapter") {
+        options.downloadSections = "intro";
+    } else if (selectedSection == "Download first 5 minutes") {
+        options.downloadSections = "*0:00-5:00";
+    } else if (selectedSection == "Download last 5 minutes") {
+        options.downloadSections = "*-5:00-inf";
+    } else if (selectedSection == "Custom chapter regex") {
+        options.downloadSections = downloadSectionsTextBox->text().trimmed();
+    } else if (selectedSection == "Custom time range") {
+        QString timeRange = downloadSectionsTextBox->text().trimmed();
+        if (!timeRange.isEmpty()) {
+            options.downloadSections = "*" + timeRange;
+        }
+    }
+    options.formatCode = selectedFormatCodeTextBox->text().trimmed();
     if (useAria2cCheck->isChecked()) {
         int index = aria2cOptionsCombo->currentIndex();
         if (index >= 0) {
@@ -2166,18 +2370,13 @@ QStringList MainWindow::buildCommand() {
                 "-x 8 -s 8 -k 4M",
                 "-x 16 -s 16 -k 8M"
             };
-            args << "--external-downloader" << "aria2c";
-            args << "--external-downloader-args" << aria2cArgsList[index];
+            options.aria2cArgs = aria2cArgsList[index];
         }
     }
     if (audioOnlyCheck->isChecked()) {
-        args << "-x";
-        args << "--audio-format" << audioFormatCombo->currentText();
-    }
-    if (!urlsToDownload.isEmpty()) {
-        args += urlsToDownload;
+        options.audioFormat = audioFormatCombo->currentText();
     }
-    return args;
+    return options;
 }
 
 void MainWindow::onSaveConfigClicked() {
@@ -2206,7 +2405,17 @@ void MainWindow::onSaveConfigClicked() {
     QTextStream out(&configFile);
     QStringList args = buildCommand();
     args.removeAll("--progress");
+    args.removeAll("--newline");
     args.removeAll("--ignore-config");
+    int templateIndex = args.indexOf("--progress-template");
+    if (templateIndex != -1) {
+        args.remove(templateIndex, 2);
+    }
+    // The archive belongs to the selected bookmark, not to every yt-dlp run
+    int archiveIndex = args.indexOf("--download-archive");
+    if (archiveIndex != -1) {
+        args.remove(archiveIndex, 2);
+    }
     for (const QString &url : urlTextBox->text().split(' ', Qt::SkipEmptyParts)) {
         args.removeAll(url);
     }
@@ -2229,107 +2438,252 @@ void MainWindow::onSaveConfigClicked() {
 }
 
 void MainWindow::onListFormatsClicked() {
-    QString url = urlTextBox->text().trimmed();
-    if (url.isEmpty()) {
-        formatsTextEdit->append("Please enter a URL");
+    QStringList urls = urlTextBox->text().split(' ', Qt::SkipEmptyParts);
+    urls.removeDuplicates();
+    if (urls.isEmpty()) {
+        setListStatus(formatsStatusLabel, "Please enter a URL", true);
         return;
     }
-    QStringList urls = url.split(' ', Qt::SkipEmptyParts);
-    QString firstUrl = urls.first();
-    formatsTextEdit->clear();
-    formatsTextEdit->append("Listing formats for: " + firstUrl);
-    listFormatsButton->setEnabled(false);
-    QProcess *listProcess = new QProcess(this);
-    connect(listProcess, &QProcess::readyReadStandardOutput, [this, listProcess]() {
-        QByteArray output = listProcess->readAllStandardOutput();
-        QString outputStr = QString::fromUtf8(output).trimmed();
-        if (!outputStr.isEmpty()) {
-            formatsTextEdit->append(outputStr);
+    QString shownUrl = formatsUrlComboBox->currentData().toString();
+    formatErrors.clear();
+    formatFetcher->clearPending();
+    {
+        QSignalBlocker blocker(formatsUrlComboBox);
+        formatsUrlComboBox->clear();
+        for (const QString &url : std::as_const(urls)) {
+            const VideoFormats *formats = formatFetcher->cached(url);
+            formatsUrlComboBox->addItem(formats && !formats->title.isEmpty() ? formats->title : url, url);
         }
-    });
-    connect(listProcess, &QProcess::readyReadStandardError, [this, listProcess]() {
-        QByteArray error = listProcess->readAllStandardError();
-        QString errorStr = QString::fromUtf8(error).trimmed();
-        if (!errorStr.isEmpty()) {
-            formatsTextEdit->append("Error: " + errorStr);
-        }
-    });
-    connect(listProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [this, listProcess](int exitCode, QProcess::ExitStatus exitStatus) {
-        listFormatsButton->setEnabled(true);
-        if (exitStatus == QProcess::CrashExit) {
-            formatsTextEdit->append("Format listing process crashed.");
-        } else if (exitCode != 0) {
-            formatsTextEdit->append("Format listing failed with exit code " + QString::number(exitCode));
+        formatsUrlComboBox->setCurrentIndex(qMax(0, urls.indexOf(shownUrl)));
+    }
+    listFormatsButton->setEnabled(false);
+    // Cached URLs answer right away, the rest run a few at a time
+    formatFetcher->request(urls);
+    showFormats(formatsUrlComboBox->currentData().toString());
+}
+
+void MainWindow::onFormatsReady(const QString &url, const VideoFormats &formats) {
+    int index = formatsUrlComboBox->findData(url);
+    if (index < 0) {
+        return;
+    }
+    if (!formats.title.isEmpty()) {
+        formatsUrlComboBox->setItemText(index, formats.title);
+    }
+    if (index == formatsUrlComboBox->currentIndex()) {
+        showFormats(url);
+    }
+}
+
+void MainWindow::onFormatsFailed(const QString &url, const QString &error) {
+    consoleTextEdit->append("Error: Couldn't list formats for " + url + ": " + error);
+    int index = formatsUrlComboBox->findData(url);
+    if (index < 0) {
+        return;
+    }
+    formatErrors.insert(url, error);
+    if (index == formatsUrlComboBox->currentIndex()) {
+        showFormats(url);
+    }
+}
+
+void MainWindow::showFormats(const QString &url) {
+    formatsTable->setSortingEnabled(false);
+    formatsTable->setRowCount(0);
+    refreshFormatsButton->setEnabled(!url.isEmpty());
+    const VideoFormats *formats = url.isEmpty() ? nullptr : formatFetcher->cached(url);
+    if (!formats) {
+        formatsTable->setSortingEnabled(true);
+        if (url.isEmpty()) {
+            setListStatus(formatsStatusLabel, QString());
+        } else if (formatErrors.contains(url)) {
+            setListStatus(formatsStatusLabel, "Error: " + formatErrors.value(url), true);
         } else {
-            formatsTextEdit->append("Finished listing formats.");
+            setListStatus(formatsStatusLabel, "Listing formats for: " + url);
         }
-        listProcess->deleteLater();
-    });
-    listProcess->start("yt-dlp", QStringList() << "-F" << firstUrl);
+        return;
+    }
+    formatsTable->setRowCount(formats->formats.size());
+    for (int row = 0; row < formats->formats.size(); ++row) {
+        const FormatEntry &format = formats->formats.at(row);
+        QString size;
+        if (format.filesize >= 0) {
+            size = (format.approxSize ? "~" : "") + QLocale().formattedDataSize(format.filesize);
+        }
+        // Audio only formats have no height, their bitrate still orders them among themselves
+        double resolutionKey = format.height * 100000.0 + format.tbr;
+        formatsTable->setItem(row, 0, new QTableWidgetItem(format.formatId));
+        formatsTable->setItem(row, 1, new QTableWidgetItem(format.ext));
+        formatsTable->setItem(row, 2, new SortableTableItem(format.resolution, resolutionKey));
+        formatsTable->setItem(row, 3, new SortableTableItem(format.fps > 0 ? QString::number(format.fps) : QString(), format.fps));
+        formatsTable->setItem(row, 4, new QTableWidgetItem(format.codec()));
+        formatsTable->setItem(row, 5, new SortableTableItem(format.tbr > 0 ? QString::number(format.tbr, 'f', 0) + "k" : QString(), format.tbr));
+        formatsTable->setItem(row, 6, new SortableTableItem(size, format.filesize));
+        formatsTable->setItem(row, 7, new QTableWidgetItem(format.note));
+    }
+    formatsTable->setSortingEnabled(true);
+    int age = formats->fetchedAt.secsTo(QDateTime::currentDateTime()) / 60;
+    setListStatus(formatsStatusLabel, QString("%1 formats for %2%3").arg(formats->formats.size())
+                  .arg(formats->title.isEmpty() ? url : formats->title)
+                  .arg(age > 0 ? QString(" (looked up %1 min ago)").arg(age) : QString()));
 }
 
-void MainWindow::startDownload() {
-    QStringList args = buildCommand();
-    if (args.isEmpty()) {
-        consoleTextEdit->append("Error: No valid download command generated.");
+void MainWindow::startDownload(const QStringList &urls) {
+    QStringList jobUrls = urls.isEmpty() ? urlTextBox->text().split(' ', Qt::SkipEmptyParts) : urls;
+    if (jobUrls.isEmpty()) {
+        consoleTextEdit->append("Error: No URLs provided for download.");
         statusBar->showMessage("Error: No valid download command.", 5000);
-        downloadButton->setEnabled(true);
-        cancelButton->setVisible(false);
-        progressBar->setVisible(false);
-        downloadState = DownloadState::Idle;
-        emit downloadFinished();
         return;
     }
-    process = new QProcess(this);
-    downloadState = DownloadState::Downloading;
-    progressBar->setFormat("%p%");
-    connect(process, &QProcess::readyReadStandardOutput, this, &MainWindow::onProcessOutput);
-    connect(process, &QProcess::errorOccurred, [this](QProcess::ProcessError /*error*/) {
-        consoleTextEdit->append("Process error: " + process->errorString());
-        statusBar->showMessage("Process error: " + process->errorString(), 5000);
-        downloadButton->setEnabled(true);
-        cancelButton->setVisible(false);
-        progressBar->setVisible(false);
-        downloadState = DownloadState::Idle;
-        emit downloadFinished();
-    });
-    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [this](int, QProcess::ExitStatus) {
-        consoleTextEdit->append("Download finished.");
-        statusBar->showMessage("Download finished", 5000);
-        downloadButton->setEnabled(true);
-        cancelButton->setVisible(false);
-        progressBar->setVisible(false);
-        downloadState = DownloadState::Idle;
-        emit downloadFinished();
-    });
-    process->start("yt-dlp", args);
+    DownloadOptionsSnapshot options = optionsFor(urls);
+    // Picked playlist items only make sense together with their playlist URL
+    QList<QStringList> batches;
+    if (!options->playlistItems.isEmpty()) {
+        batches << jobUrls;
+    } else {
+        for (const QString &url : std::as_const(jobUrls)) {
+            batches << QStringList(url);
+        }
+    }
+    int queued = 0;
+    int lastId = 0;
+    int archived = 0;
+    QStringList alreadyQueued;
+    // Videos the bookmark's archive already has never get a yt-dlp started for them
+    if (!options->downloadArchive.isEmpty()) {
+        DownloadArchive::createDirectory(options->downloadArchive);
+    }
+    bool useArchive = !options->downloadArchive.isEmpty() && options->downloadArchive == channelArchive.path();
+    if (useArchive) {
+        channelModel->addArchivedIds(channelArchive.refresh());
+    }
+    for (const QStringList &batch : std::as_const(batches)) {
+        if (useArchive && batch.size() == 1 && channelArchive.contains(UrlClassifier::classify(batch.first()).videoId)) {
+            archived++;
+            continue;
+        }
+        int existing = downloadQueue->findActiveJob(options, batch);
+        if (existing != 0) {
+            alreadyQueued << QString("#%1").arg(existing);
+            continue;
+        }
+        lastId = downloadQueue->enqueue(batch.join(" "), options, batch);
+        queued++;
+        if (batches.size() <= 10) {
+            consoleTextEdit->append(QString("Queued download #%1: %2").arg(lastId).arg(batch.join(" ")));
+        }
+    }
+    if (!alreadyQueued.isEmpty()) {
+        consoleTextEdit->append(QString("Already queued with the same options: %1").arg(alreadyQueued.join(", ")));
+    }
+    if (archived > 0) {
+        consoleTextEdit->append(QString("Skipped %1 already downloaded %2.").arg(archived).arg(archived == 1 ? "video" : "videos"));
+    }
+    if (queued == 1) {
+        statusBar->showMessage(QString("Queued download #%1").arg(lastId), 5000);
+    } else if (queued > 1) {
+        consoleTextEdit->append(QString("Queued %1 downloads.").arg(queued));
+        statusBar->showMessage(QString("Queued %1 downloads").arg(queued), 5000);
+    } else if (!alreadyQueued.isEmpty()) {
+        statusBar->showMessage(QString("Already queued as %1").arg(alreadyQueued.join(", ")), 5000);
+    } else {
+        statusBar->showMessage("Everything selected was already downloaded", 5000);
+    }
+    prefetchAhead();
+}
+
+void MainWindow::onImportUrlsClicked() {
+    QString fileName = QFileDialog::getOpenFileName(this, "Import URLs", QDir::homePath(), "Text files (*.txt);;All files (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        consoleTextEdit->append("Error: Couldn't open " + fileName + ": " + file.errorString());
+        QMessageBox::warning(this, "Import Error", "Failed to open the URL file: " + file.errorString());
+        return;
+    }
+    // One URL per line, blank lines and # comments are ignored, same as yt-dlp's --batch-file
+    QStringList urls;
+    QSet<QString> seen;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) {
+            continue;
+        }
+        for (const QString &url : line.split(' ', Qt::SkipEmptyParts)) {
+            if (!seen.contains(url)) {
+                seen.insert(url);
+                urls << url;
+            }
+        }
+    }
+    if (urls.isEmpty()) {
+        consoleTextEdit->append("No URLs found in " + fileName);
+        statusBar->showMessage("No URLs found in the file", 5000);
+        return;
+    }
+    if (!prepareOutputDirectory()) {
+        return;
+    }
+    consoleTextEdit->append(QString("Imported %1 URLs from %2").arg(urls.size()).arg(fileName));
+    startDownload(urls);
+}
+
+void MainWindow::prefetchAhead() {
+    // Only the next few waiting jobs, a file of thousands of URLs shouldn't turn into thousands of lookups at once
+    QStringList urls;
+    const QList<int> pendingIds = downloadQueue->pendingJobs();
+    for (int i = 0; i < pendingIds.size() && i < PrefetchAhead; ++i) {
+        DownloadJob job = downloadQueue->job(pendingIds.at(i));
+        if (job.urls.size() != 1 || prefetchJobs.contains(job.urls.first()) || retriedJobs.contains(job.id)) {
+            continue;
+        }
+        const QString &url = job.urls.first();
+        UrlInfo::Kind kind = UrlClassifier::classify(url).kind;
+        if (kind != UrlInfo::Kind::Video && kind != UrlInfo::Kind::Short) {
+            continue;
+        }
+        prefetchJobs.insert(url, job.id);
+        urls << url;
+    }
+    metadataPrefetcher->request(urls);
+}
+
+void MainWindow::onMetadataReady(const QString &url, const QString &title) {
+    int id = prefetchJobs.value(url);
+    if (id != 0) {
+        downloadQueue->setLabel(id, title);
+    }
+}
+
+void MainWindow::onMetadataUnavailable(const QString &url, const QString &reason) {
+    // Skipping finishes the job, which moves the prefetch window along. The lookup
+    // is anonymous, a job with a login or cookies may well see a "private" video
+    int id = prefetchJobs.value(url);
+    if (id == 0) {
+        return;
+    }
+    DownloadJob job = downloadQueue->job(id);
+    if (job.options && job.options->hasCredentials()) {
+        return;
+    }
+    downloadQueue->skip(id, reason);
 }
 
 void MainWindow::onListPlaylistClicked() {
     QString url = urlTextBox->text().trimmed();
     if (url.isEmpty()) {
-        QListWidgetItem *item = new QListWidgetItem("Please enter a playlist URL");
-        item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-        item->setForeground(Qt::red);
-        playlistListWidget->addItem(item);
+        setListStatus(playlistStatusLabel, "Please enter a playlist URL", true);
         QMessageBox::warning(this, "Empty URL", "Please enter a playlist URL.");
         return;
     }
     playlistSearchTextBox->clear();
 
-    QRegularExpression playlistRegex(
-        "^https?://(?:(?:www|m)\\.)?youtube\\.(?:com|co\\.[a-zA-Z]{2})/(?:playlist\\?list=[a-zA-Z0-9_.-]+|watch\\?v=[a-zA-Z0-9_.-]+&list=[a-zA-Z0-9_.-]+.*)$",
-                                     QRegularExpression::CaseInsensitiveOption
-    );
-    QRegularExpression channelRegex(
-        "^https?://(?:(?:www|m)\\.)?youtube\\.(?:com|co\\.[a-zA-Z]{2})/(?:(?:c/|channel/|user/|@[a-zA-Z0-9_.-]+)(?:/|$))",
-                                    QRegularExpression::CaseInsensitiveOption
-    );
-    if (channelRegex.match(url).hasMatch()) {
-        QListWidgetItem *item = new QListWidgetItem("Invalid URL: Channel URLs should be used in the 'Channel Browser' tab");
-        item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-        item->setForeground(Qt::red);
-        playlistListWidget->addItem(item);
+    UrlInfo urlInfo = UrlClassifier::classify(url);
+    if (urlInfo.isChannel()) {
+        setListStatus(playlistStatusLabel, "Invalid URL: Channel URLs should be used in the 'Channel Browser' tab", true);
         QMessageBox::warning(this, "Invalid URL",
                              "The entered URL is a channel URL. Please use the 'Channel Browser' tab for channel URLs.\n\n"
                              "Valid playlist examples:\n"
@@ -2338,11 +2692,8 @@ void MainWindow::onListPlaylistClicked() {
                              "For channel URLs like https://www.youtube.com/@ChannelName/videos, use the 'Channel Browser' tab.");
         return;
     }
-    if (!playlistRegex.match(url).hasMatch()) {
-        QListWidgetItem *item = new QListWidgetItem("Invalid URL: Please enter a valid YouTube playlist URL");
-        item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-        item->setForeground(Qt::red);
-        playlistListWidget->addItem(item);
+    if (!urlInfo.isPlaylist()) {
+        setListStatus(playlistStatusLabel, "Invalid URL: Please enter a valid YouTube playlist URL", true);
         QMessageBox::warning(this, "Invalid URL",
                              "The entered URL is not a valid YouTube playlist URL.\n\n"
                              "Valid examples:\n"
@@ -2351,15 +2702,18 @@ void MainWindow::onListPlaylistClicked() {
         return;
     }
 
+    QStringList args = {"--get-title", "--flat-playlist", url};
+    bool existing = false;
+    QProcess *listProcess = helperProcesses->request("playlist-list", args, true, &existing);
+    if (existing) {
+        setListStatus(playlistStatusLabel, "Already listing this playlist...");
+        return;
+    }
     playlistOutput.clear();
-    playlistListWidget->clear();
-    QListWidgetItem *startItem = new QListWidgetItem("Listing videos...");
-    startItem->setFlags(startItem->flags() & ~Qt::ItemIsUserCheckable);
-    playlistListWidget->addItem(startItem);
+    playlistModel->clear();
+    setListStatus(playlistStatusLabel, "Listing videos...");
     listPlaylistButton->setEnabled(false);
 
-    QProcess *listProcess = new QProcess(this);
-
     connect(listProcess, &QProcess::readyReadStandardOutput, [this, listProcess]() {
         playlistOutput += QString::fromUtf8(listProcess->readAllStandardOutput());
     });
@@ -2368,10 +2722,7 @@ void MainWindow::onListPlaylistClicked() {
         QByteArray error = listProcess->readAllStandardError();
         QString errorStr = QString::fromUtf8(error).trimmed();
         if (!errorStr.isEmpty()) {
-            QListWidgetItem *item = new QListWidgetItem("Error: " + errorStr);
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::red);
-            playlistListWidget->addItem(item);
+            setListStatus(playlistStatusLabel, "Error: " + errorStr, true);
         }
     });
 
@@ -2379,66 +2730,47 @@ void MainWindow::onListPlaylistClicked() {
     connect(listProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [this, listProcess](int exitCode, QProcess::ExitStatus exitStatus) {
         listPlaylistButton->setEnabled(true);
         if (exitStatus == QProcess::CrashExit) {
-            QListWidgetItem *item = new QListWidgetItem("Video listing process crashed.");
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::red);
-            playlistListWidget->addItem(item);
+            setListStatus(playlistStatusLabel, "Video listing process crashed.", true);
         } else if (exitCode != 0) {
-            QListWidgetItem *item = new QListWidgetItem("Video listing failed with exit code " + QString::number(exitCode));
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::red);
-            playlistListWidget->addItem(item);
+            setListStatus(playlistStatusLabel, "Video listing failed with exit code " + QString::number(exitCode), true);
         } else {
-            originalPlaylistTitles.clear();
-            QStringList titles = playlistOutput.split('\n', Qt::SkipEmptyParts);
+            QVector<VideoEntry> entries;
+            const QStringList titles = playlistOutput.split('\n', Qt::SkipEmptyParts);
             for (const QString& title : titles) {
                 QString trimmedTitle = title.trimmed();
                 if (!trimmedTitle.isEmpty()) {
-                    originalPlaylistTitles.append(trimmedTitle);
+                    VideoEntry entry;
+                    entry.title = trimmedTitle;
+                    entries.append(entry);
                 }
             }
-            playlistListWidget->clear();
-            for (int i = 0; i < originalPlaylistTitles.size(); ++i) {
-                const QString& title = originalPlaylistTitles[i];
-                QListWidgetItem *item = new QListWidgetItem(title);
-                item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-                item->setCheckState(Qt::Unchecked);
-                item->setData(OriginalIndexRole, i + 1);
-                playlistListWidget->addItem(item);
-            }
-            QListWidgetItem *item = new QListWidgetItem("Finished listing videos.");
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::gray);
-            playlistListWidget->addItem(item);
+            playlistModel->appendEntries(entries);
+            setListStatus(playlistStatusLabel, QString("Finished listing videos (%1).").arg(entries.size()));
         }
         listProcess->deleteLater();
     });
 
-    QStringList args = {"--get-title", "--flat-playlist", url};
-    listProcess->start("yt-dlp", args);
+    connect(listProcess, &QProcess::errorOccurred, this, [this, listProcess](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            listPlaylistButton->setEnabled(true);
+            setListStatus(playlistStatusLabel, "Couldn't start yt-dlp: " + listProcess->errorString(), true);
+            listProcess->deleteLater();
+        }
+    });
 }
 
 void MainWindow::onListChannelClicked() {
+    channelListTimer->stop();
     QString url = urlTextBox->text().trimmed();
     if (url.isEmpty()) {
-        QListWidgetItem *item = new QListWidgetItem("Please enter a channel URL");
-        item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-        item->setForeground(Qt::red);
-        channelListWidget->addItem(item);
+        setListStatus(channelStatusLabel, "Please enter a channel URL", true);
         QMessageBox::warning(this, "Empty URL", "Please enter a channel URL.");
         return;
     }
     channelSearchTextBox->clear();
-    QRegularExpression channelPathRegex(
-        "^(https?://(?:(?:www|m)\\.)?youtube\\.(?:com|co\\.[a-zA-Z]{2})/(?:(?:c/|channel/|user/|@[a-zA-Z0-9_.-]+)(?:/|$)))",
-                                        QRegularExpression::CaseInsensitiveOption
-    );
-    QRegularExpressionMatch match = channelPathRegex.match(url);
-    if (!match.hasMatch()) {
-        QListWidgetItem *item = new QListWidgetItem("Invalid URL: Please enter a valid YouTube channel URL");
-        item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-        item->setForeground(Qt::red);
-        channelListWidget->addItem(item);
+    UrlInfo urlInfo = UrlClassifier::classify(url);
+    if (!urlInfo.isChannel()) {
+        setListStatus(channelStatusLabel, "Invalid URL: Please enter a valid YouTube channel URL", true);
         QMessageBox::warning(this, "Invalid URL",
                              "The entered URL is not a valid YouTube channel URL.\n\n"
                              "Valid examples (extra paths like /videos or /featured are ignored):\n"
@@ -2455,10 +2787,7 @@ void MainWindow::onListChannelClicked() {
         return;
     }
 
-    QString normalizedUrl = match.captured(1);
-    if (normalizedUrl.endsWith('/')) {
-        normalizedUrl = normalizedUrl.left(normalizedUrl.length() - 1);
-    }
+    QString normalizedUrl = urlInfo.channelBase;
 
     QString contentType = channelContentComboBox->currentText();
     QString endpoint;
@@ -2470,357 +2799,340 @@ void MainWindow::onListChannelClicked() {
         endpoint = "/streams";
     }
     QString fullUrl = normalizedUrl + endpoint;
+    QString limitText = listLimitComboBox->currentText();
+    int limit = limitText == "All" ? 0 : limitText.toInt();
 
-    channelOutput.clear();
-    channelListWidget->clear();
-    videoCountLabel->setText("0 listed");
-    QString startMsg = "Listing " + contentType.toLower() + "...";
-    if (showUploadDatesCheck->isChecked()) {
-        startMsg += " (may take time for large lists)";
+    // Pressing List again while the same listing runs shouldn't start it over
+    if (channelListProcess && (helperProcesses->find("channel-list", channelListArgs(fullUrl, limit, false)) == channelListProcess
+                               || helperProcesses->find("channel-list", channelListArgs(fullUrl, limit, true)) == channelListProcess)) {
+        setListStatus(channelStatusLabel, "Already listing " + contentType.toLower() + "...");
+        return;
+    }
+
+    stopChannelListing();
+    channelModel->clear();
+    dateResolver->clearPending();
+    // Bookmarked channels have an archive, what's in it shows greyed out
+    if (bookmarkUrls.contains(normalizedUrl)) {
+        channelArchive.load(DownloadArchive::pathFor(normalizedUrl));
+    } else {
+        channelArchive.clear();
+    }
+    channelModel->setArchivedIds(channelArchive.ids());
+    channelListHasDates = showUploadDatesCheck->isChecked();
+    channelModel->setShowDates(channelListHasDates);
+
+    // A listing we already have is shown right away, then only the newest entries are checked
+    CachedListing cached;
+    if (ChannelCache::load(fullUrl, limit, &cached) && (cached.complete || (limit > 0 && cached.entries.size() >= limit))) {
+        channelModel->appendEntries(cached.entries);
+        updateVideoCountLabel();
+        setListStatus(channelStatusLabel, QString("Loaded %1 saved %2 (listed %3), checking for new ones...")
+                      .arg(cached.entries.size()).arg(contentType.toLower()).arg(QLocale().toString(cached.fetchedAt, QLocale::ShortFormat)));
+        startChannelListing(fullUrl, contentType, limit, true);
+    } else {
+        videoCountLabel->setText("0 listed");
+        setListStatus(channelStatusLabel, "Listing " + contentType.toLower() + "...");
+        startChannelListing(fullUrl, contentType, limit, false);
     }
-    QListWidgetItem *startItem = new QListWidgetItem(startMsg);
-    startItem->setFlags(startItem->flags() & ~Qt::ItemIsUserCheckable);
-    channelListWidget->addItem(startItem);
+}
+
+void MainWindow::scheduleChannelListing() {
+    // Whatever is running belongs to the previous selection
+    stopChannelListing();
+    channelModel->clear();
+    dateResolver->clearPending();
+    videoCountLabel->setText("0 listed");
+    setListStatus(channelStatusLabel, "Listing shortly...");
+    channelListTimer->start();
+}
+
+void MainWindow::stopChannelListing() {
+    // Only one listing feeds the list at a time
+    channelListTimer->stop();
+    if (channelListProcess) {
+        helperProcesses->cancel(channelListProcess);
+        channelListProcess = nullptr;
+    }
+    listChannelButton->setEnabled(true);
+    stopListChannelButton->setEnabled(false);
+    channelListBatchTimer->stop();
+    pendingChannelData.clear();
+    refreshEntries.clear();
+}
+
+void MainWindow::startChannelListing(const QString &fullUrl, const QString &contentType, int limit, bool refresh) {
+    channelListParser = OutputParser();
+    pendingChannelData.clear();
+    refreshEntries.clear();
+    channelRefreshHitKnown = false;
     listChannelButton->setEnabled(false);
+    stopListChannelButton->setEnabled(true);
 
-    QProcess *listProcess = new QProcess(this);
+    // Any other channel listing belongs to an older selection and is cancelled by the registry
+    QProcess *listProcess = helperProcesses->request("channel-list", channelListArgs(fullUrl, limit, refresh));
+    channelListProcess = listProcess;
 
-    connect(listProcess, &QProcess::readyReadStandardOutput, [this, listProcess]() {
-        channelOutput += QString::fromUtf8(listProcess->readAllStandardOutput());
+    // Complete lines become entries right away, the list itself is only touched once per batch
+    connect(listProcess, &QProcess::readyReadStandardOutput, [this, listProcess, refresh]() {
+        const QVector<OutputEvent> events = channelListParser.feed(listProcess->readAllStandardOutput());
+        for (const OutputEvent &event : events) {
+            addChannelListLine(event.line, refresh);
+        }
+        if (!pendingChannelData.isEmpty() && !channelListBatchTimer->isActive()) {
+            channelListBatchTimer->start();
+        }
     });
 
     connect(listProcess, &QProcess::readyReadStandardError, [this, listProcess]() {
         QByteArray error = listProcess->readAllStandardError();
         QString errorStr = QString::fromUtf8(error).trimmed();
         if (!errorStr.isEmpty()) {
-            QListWidgetItem *item = new QListWidgetItem("Error: " + errorStr);
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::red);
-            channelListWidget->addItem(item);
+            setListStatus(channelStatusLabel, "Error: " + errorStr, true);
             consoleTextEdit->append("Error: " + errorStr);
             statusBar->showMessage("Error listing videos.", 5000);
         }
     });
 
-    // Process the output when finished
-    connect(listProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [this, listProcess, contentType, fullUrl](int exitCode, QProcess::ExitStatus exitStatus) {
+    connect(listProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [this, listProcess, contentType, fullUrl, limit, refresh](int exitCode, QProcess::ExitStatus exitStatus) {
+        channelListProcess = nullptr;
         listChannelButton->setEnabled(true);
-        if (exitStatus == QProcess::CrashExit) {
-            QListWidgetItem *item = new QListWidgetItem(contentType + " listing process crashed.");
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::red);
-            channelListWidget->addItem(item);
+        stopListChannelButton->setEnabled(false);
+        for (const OutputEvent &event : channelListParser.flush()) {
+            addChannelListLine(event.line, refresh);
+        }
+        channelListBatchTimer->stop();
+        flushChannelListBatch();
+        listProcess->deleteLater();
+        if (refresh) {
+            finishChannelRefresh(fullUrl, contentType, limit, exitCode == 0 && exitStatus == QProcess::NormalExit);
+        } else if (exitStatus == QProcess::CrashExit) {
+            setListStatus(channelStatusLabel, contentType + " listing process crashed.", true);
             consoleTextEdit->append(contentType + " listing process crashed for " + fullUrl);
             statusBar->showMessage(contentType + " listing process crashed.", 5000);
         } else if (exitCode != 0) {
-            QListWidgetItem *item = new QListWidgetItem(contentType + " listing failed with exit code " + QString::number(exitCode));
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::red);
-            channelListWidget->addItem(item);
+            setListStatus(channelStatusLabel, contentType + " listing failed with exit code " + QString::number(exitCode), true);
             consoleTextEdit->append(contentType + " listing failed with exit code " + QString::number(exitCode));
             statusBar->showMessage(contentType + " listing failed.", 5000);
         } else {
-            originalChannelData.clear();
-            QStringList lines = channelOutput.split('\n', Qt::SkipEmptyParts);
-            channelListWidget->clear();
-            bool showDates = showUploadDatesCheck->isChecked();
-            for (int i = 0; i < lines.size(); ++i) {
-                QString line = lines[i].trimmed();
-                if (line.isEmpty()) continue;
-                QString title;
-                QString formattedDate = "";
-                if (showDates) {
-                    QStringList parts = line.split('\t');
-                    title = parts.value(0).trimmed();
-                    QString rawDate = parts.value(1).trimmed();
-                    if (!rawDate.isEmpty() && rawDate != "NA" && rawDate.length() == 8) {
-                        formattedDate = rawDate.left(4) + "-" + rawDate.mid(4, 2) + "-" + rawDate.right(2);
-                    }
-                } else {
-                    title = line;
-                }
-                QString displayText = title;
-                if (!formattedDate.isEmpty()) {
-                    displayText += " (" + formattedDate + ")";
-                }
-                originalChannelData.append(qMakePair(title, formattedDate));
-                QListWidgetItem *item = new QListWidgetItem(displayText);
-                item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-                item->setCheckState(Qt::Unchecked);
-                item->setData(OriginalIndexRole, i + 1);
-                channelListWidget->addItem(item);
+            setListStatus(channelStatusLabel, "Finished listing " + contentType.toLower() + ".");
+            consoleTextEdit->append(QString("Finished listing %1 (%2 items).").arg(contentType.toLower()).arg(channelModel->entryCount()));
+            statusBar->showMessage(QString("Listed %1 %2.").arg(channelModel->entryCount()).arg(contentType.toLower()), 5000);
+            if (!ChannelCache::save(fullUrl, channelModel->entryList(), limit == 0)) {
+                consoleTextEdit->append("Error: Couldn't save the channel listing: " + QSqlDatabase::database().lastError().text());
             }
-            updateUseSelectedChannelCheck();
-            QListWidgetItem *item = new QListWidgetItem("Finished listing " + contentType.toLower() + ".");
-            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setForeground(Qt::gray);
-            channelListWidget->addItem(item);
-            videoCountLabel->setText(QString("%1 listed").arg(originalChannelData.size()));
-            consoleTextEdit->append(QString("Finished listing %1 (%2 items).").arg(contentType.toLower()).arg(originalChannelData.size()));
-            statusBar->showMessage(QString("Listed %1 %2.").arg(originalChannelData.size()).arg(contentType.toLower()), 5000);
         }
-        listProcess->deleteLater();
     });
 
+    connect(listProcess, &QProcess::errorOccurred, this, [this, listProcess](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            channelListProcess = nullptr;
+            listChannelButton->setEnabled(true);
+            stopListChannelButton->setEnabled(false);
+            setListStatus(channelStatusLabel, "Couldn't start yt-dlp: " + listProcess->errorString(), true);
+            consoleTextEdit->append("Error: Couldn't start yt-dlp: " + listProcess->errorString());
+            listProcess->deleteLater();
+        }
+    });
+}
+
+QStringList MainWindow::channelListArgs(const QString &fullUrl, int limit, bool refresh) {
+    // Keep the id and url of every entry so selected downloads can use them directly.
+    // Dates come from the flat listing too (approximate on YouTube), exact ones are filled in later by dateResolver
     QStringList args;
-    bool showDates = showUploadDatesCheck->isChecked();
-    if (showDates) {
-        args << "--print" << "%(title)s\t%(upload_date)s";
-    } else {
-        args << "--get-title" << "--flat-playlist";
-    }
-    QString limit = listLimitComboBox->currentText();
-    if (limit != "All") {
-        args << "--playlist-end" << limit;
+    args << "--flat-playlist" << "--extractor-args" << "youtubetab:approximate_date"
+         << "--print" << "%(id)s\t%(url)s\t%(timestamp,release_timestamp)s\t%(title)s";
+    if (refresh) {
+        args << "--playlist-end" << QString::number(limit > 0 ? qMin(limit, ChannelRefreshSize) : ChannelRefreshSize);
+    } else if (limit > 0) {
+        args << "--playlist-end" << QString::number(limit);
     }
     args << fullUrl;
-    listProcess->start("yt-dlp", args);
+    return args;
 }
 
-void MainWindow::onPlaylistSearchTextChanged(const QString &text) {
-    playlistListWidget->clear();
-    QString searchText = text.trimmed().toLower();
-
-    if (searchText.isEmpty()) {
-        for (int i = 0; i < originalPlaylistTitles.size(); ++i) {
-            const QString& title = originalPlaylistTitles[i];
-            QListWidgetItem *item = new QListWidgetItem(title);
-            item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-            item->setCheckState(Qt::Unchecked);
-            item->setData(OriginalIndexRole, i + 1);
-            playlistListWidget->addItem(item);
-        }
-    } else {
-        for (int i = 0; i < originalPlaylistTitles.size(); ++i) {
-            const QString& title = originalPlaylistTitles[i];
-            if (title.toLower().contains(searchText)) {
-                QListWidgetItem *item = new QListWidgetItem(title);
-                item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-                item->setCheckState(Qt::Unchecked);
-                item->setData(OriginalIndexRole, i + 1);
-                playlistListWidget->addItem(item);
-            }
-        }
+void MainWindow::addChannelListLine(const QString &line, bool refresh) {
+    VideoEntry entry = parseChannelListLine(line);
+    if (!refresh) {
+        pendingChannelData.append(entry);
+        return;
     }
-}
-
-void MainWindow::onChannelSearchTextChanged(const QString &text) {
-    channelListWidget->clear();
-    QString searchText = text.trimmed().toLower();
-    bool showDates = showUploadDatesCheck->isChecked();
-
-    for (int i = 0; i < originalChannelData.size(); ++i) {
-        const QPair<QString, QString>& data = originalChannelData[i];
-        const QString& title = data.first;
-        const QString& formattedDate = data.second;
-        if (searchText.isEmpty() || title.toLower().contains(searchText)) {
-            QString displayText = title;
-            if (showDates && !formattedDate.isEmpty()) {
-                displayText += " (" + formattedDate + ")";
-            }
-            QListWidgetItem *item = new QListWidgetItem(displayText);
-            item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-            item->setCheckState(Qt::Unchecked);
-            item->setData(OriginalIndexRole, i + 1);
-            channelListWidget->addItem(item);
+    if (channelRefreshHitKnown) {
+        return;
+    }
+    if (!entry.id.isEmpty() && channelModel->rowForId(entry.id) >= 0) {
+        // Everything from here on is already saved
+        channelRefreshHitKnown = true;
+        if (channelListProcess) {
+            channelListProcess->kill();
         }
+        return;
     }
-    videoCountLabel->setText(QString("%1 listed").arg(channelListWidget->count()));
-    updateUseSelectedChannelCheck();
+    refreshEntries.append(entry);
 }
 
-QString MainWindow::generatePlaylistItems(const QList<int>& indices) {
-    if (indices.isEmpty()) return "";
-    QList<int> sortedIndices = indices;
-    std::sort(sortedIndices.begin(), sortedIndices.end());
-    QStringList items;
-    int start = sortedIndices[0];
-    int end = start;
-    for (int i = 1; i < sortedIndices.size(); ++i) {
-        if (sortedIndices[i] == end + 1) {
-            end = sortedIndices[i];
-        } else {
-            if (start == end) {
-                items << QString::number(start);
-            } else {
-                items << QString("%1-%2").arg(start).arg(end);
-            }
-            start = sortedIndices[i];
-            end = start;
-        }
-    }
-    if (start == end) {
-        items << QString::number(start);
+void MainWindow::finishChannelRefresh(const QString &fullUrl, const QString &contentType, int limit, bool listEnded) {
+    int refreshSize = limit > 0 ? qMin(limit, ChannelRefreshSize) : ChannelRefreshSize;
+    if (channelRefreshHitKnown) {
+        channelModel->prependEntries(refreshEntries);
+        if (limit > 0) {
+            channelModel->truncate(limit);
+        }
+        if (!refreshEntries.isEmpty() && !ChannelCache::prepend(fullUrl, refreshEntries, limit)) {
+            consoleTextEdit->append("Error: Couldn't save the channel listing: " + QSqlDatabase::database().lastError().text());
+        }
+        updateVideoCountLabel();
+        setListStatus(channelStatusLabel, QString("Up to date, %1 new %2.").arg(refreshEntries.size()).arg(contentType.toLower()));
+        consoleTextEdit->append(QString("Refreshed saved %1 listing for %2 (%3 new).").arg(contentType.toLower(), fullUrl).arg(refreshEntries.size()));
+    } else if (listEnded && (refreshEntries.size() < refreshSize || limit == refreshSize)) {
+        // Nothing we knew is left in what the channel returned, so it replaces the saved list
+        channelModel->clear();
+        channelModel->appendEntries(refreshEntries);
+        if (!ChannelCache::save(fullUrl, refreshEntries, limit == 0)) {
+            consoleTextEdit->append("Error: Couldn't save the channel listing: " + QSqlDatabase::database().lastError().text());
+        }
+        updateVideoCountLabel();
+        setListStatus(channelStatusLabel, "Finished listing " + contentType.toLower() + ".");
+    } else if (listEnded) {
+        // More new videos than one refresh covers, list everything again
+        consoleTextEdit->append(QString("More than %1 new %2 on %3, listing again.").arg(refreshSize).arg(contentType.toLower(), fullUrl));
+        channelModel->clear();
+        setListStatus(channelStatusLabel, "Listing " + contentType.toLower() + "...");
+        startChannelListing(fullUrl, contentType, limit, false);
     } else {
-        items << QString("%1-%2").arg(start).arg(end);
+        setListStatus(channelStatusLabel, QString("Couldn't check for new %1, showing the saved list.").arg(contentType.toLower()), true);
     }
-    return items.join(",");
+    refreshEntries.clear();
 }
 
-QStringList MainWindow::getSelectedChannelVideoUrls(const QString& channelUrl, const QString& endpoint, const QList<int>& indices) {
-    QStringList videoUrls;
-    if (indices.isEmpty()) {
-        consoleTextEdit->append("Error: No indices selected for channel download.");
-        statusBar->showMessage("Error: No indices selected for channel download.", 5000);
-        emit downloadFinished();
-        return videoUrls;
-    }
-
-    QString fullUrl = channelUrl + endpoint;
-    this->channelUrl = channelUrl;
-    this->endpoint = endpoint;
-    this->indices = indices;
-    this->fetchAttempt = 0;
-    this->maxRetries = 3;
-    this->channelOutput.clear();
+// Lines are "id<TAB>url<TAB>timestamp<TAB>title", title last so a tab inside it can't shift the other fields
+VideoEntry MainWindow::parseChannelListLine(const QString &line) {
+    VideoEntry entry;
+    QStringView rest = QStringView(line).trimmed();
+    QStringView fields[3];
+    for (int i = 0; i < 3; ++i) {
+        qsizetype tab = rest.indexOf(u'\t');
+        if (tab < 0) {
+            // Not one of our lines, show it as is
+            entry.title = line.trimmed();
+            return entry;
+        }
+        fields[i] = rest.left(tab).trimmed();
+        rest = rest.mid(tab + 1);
+    }
+    entry.id = fields[0].toString();
+    entry.url = fields[1].toString();
+    if (entry.url.isEmpty() || entry.url == "NA") {
+        entry.url = "https://www.youtube.com/watch?v=" + entry.id;
+    }
+    bool ok = false;
+    qint64 timestamp = static_cast<qint64>(fields[2].toDouble(&ok));
+    if (ok && timestamp > 0) {
+        entry.date = QDateTime::fromSecsSinceEpoch(timestamp).toUTC().toString("yyyy-MM-dd");
+    }
+    entry.title = rest.trimmed().toString();
+    return entry;
+}
 
-    if (urlFetchProcess) {
-        if (urlFetchProcess->state() == QProcess::Running) {
-            urlFetchProcess->kill();
-            urlFetchProcess->waitForFinished(1000);
+void MainWindow::resolveVisibleDates() {
+    if (!channelListHasDates || channelFilterModel->rowCount() == 0) {
+        return;
+    }
+    QList<QPair<QString, QString>> videos;
+    auto addRow = [this, &videos](int row) {
+        const VideoEntry &entry = channelModel->entry(row);
+        if (!entry.exactDate && !entry.id.isEmpty()) {
+            videos.append(qMakePair(entry.id, entry.url));
         }
-        delete urlFetchProcess;
-        urlFetchProcess = nullptr;
+    };
+    int first = channelListView->indexAt(QPoint(0, 0)).row();
+    int last = channelListView->indexAt(QPoint(0, channelListView->viewport()->height() - 1)).row();
+    if (first < 0) {
+        first = 0;
     }
-
-    urlFetchProcess = new QProcess(this);
-    QStringList args = {"--get-url", "--flat-playlist", "--no-playlist", "--no-cache-dir"};
-    QString limit = listLimitComboBox->currentText();
-    if (limit != "All") {
-        args << "--playlist-end" << limit;
+    if (last < 0) {
+        last = channelFilterModel->rowCount() - 1;
     }
-    args << fullUrl;
-
-    connect(urlFetchProcess, &QProcess::readyReadStandardOutput, this, [this]() {
-        channelOutput += QString::fromUtf8(urlFetchProcess->readAllStandardOutput());
-    });
-
-    connect(urlFetchProcess, &QProcess::readyReadStandardError, this, [this]() {
-        QByteArray error = urlFetchProcess->readAllStandardError();
-        QString errorStr = QString::fromUtf8(error).trimmed();
-        if (!errorStr.isEmpty()) {
-            consoleTextEdit->append("Error retrieving video URLs: " + errorStr);
-            statusBar->showMessage("Error retrieving video URLs.", 5000);
-        }
-    });
-
-    connect(urlFetchProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &MainWindow::onUrlFetchFinished);
-
-    urlFetchProcess->start("yt-dlp", args);
-    if (!urlFetchProcess->waitForStarted(5000)) {
-        consoleTextEdit->append("Error: Failed to start process for retrieving video URLs.");
-        statusBar->showMessage("Error: Failed to start URL retrieval process.", 5000);
-        emit downloadFinished();
-        delete urlFetchProcess;
-        urlFetchProcess = nullptr;
-        return QStringList();
-    }
-
-    return QStringList();
-}
-
-void MainWindow::onUrlFetchFinished(int exitCode, QProcess::ExitStatus exitStatus) {
-    QStringList videoUrls;
-    QString fullUrl = channelUrl + endpoint;
-
-    if (exitStatus == QProcess::CrashExit || exitCode != 0) {
-        consoleTextEdit->append("Failed to retrieve video URLs (exit code: " + QString::number(exitCode) + ").");
-        statusBar->showMessage("Failed to retrieve video URLs.", 5000);
-        fetchAttempt++;
-        if (fetchAttempt < maxRetries) {
-            consoleTextEdit->append(QString("Retrying URL retrieval (attempt %1 of %2)...").arg(fetchAttempt + 1).arg(maxRetries));
-            QThread::msleep(1000);
-            if (urlFetchProcess) {
-                QStringList retryArgs = {"--get-url", "--flat-playlist", "--no-playlist", "--no-cache-dir"};
-                QString limit = listLimitComboBox->currentText();
-                if (limit != "All") {
-                    retryArgs << "--playlist-end" << limit;
-                }
-                retryArgs << fullUrl;
-                urlFetchProcess->start("yt-dlp", retryArgs);
-            } else {
-                consoleTextEdit->append("Error: URL fetch process unavailable for retry.");
-                statusBar->showMessage("Error: URL fetch process unavailable.", 5000);
-                downloadButton->setEnabled(true);
-                cancelButton->setVisible(false);
-                progressBar->setVisible(false);
-                downloadState = DownloadState::Idle;
-                emit downloadFinished();
-            }
-            return;
-        } else {
-            consoleTextEdit->append("Error: No valid video URLs retrieved after " + QString::number(maxRetries) + " attempts.");
-            statusBar->showMessage("Error: No valid video URLs retrieved.", 5000);
-            downloadButton->setEnabled(true);
-            cancelButton->setVisible(false);
-            progressBar->setVisible(false);
-            downloadState = DownloadState::Idle;
-            emit downloadFinished();
-            if (urlFetchProcess) {
-                delete urlFetchProcess;
-                urlFetchProcess = nullptr;
-            }
-            return;
+    for (int row = first; row <= last; ++row) {
+        int sourceRow = channelFilterModel->sourceRow(row);
+        if (sourceRow >= 0) {
+            addRow(sourceRow);
         }
     }
-
-    QStringList allUrls = channelOutput.split('\n', Qt::SkipEmptyParts);
-    for (QString& url : allUrls) {
-        url = url.trimmed();
+    const QList<int> checkedRows = channelModel->checkedIndices();
+    for (int index : checkedRows) {
+        addRow(index - 1);
     }
+    // Scrolling away drops what was only queued for the old view
+    dateResolver->clearPending();
+    dateResolver->request(videos);
+}
 
-    for (int index : indices) {
-        if (index > 0 && index <= allUrls.size()) {
-            videoUrls << allUrls[index - 1];
-            consoleTextEdit->append(QString("Selected URL %1: %2").arg(index).arg(allUrls[index - 1]));
-        } else {
-            consoleTextEdit->append(QString("Warning: Index %1 is out of range (max %2).").arg(index).arg(allUrls.size()));
-            statusBar->showMessage(QString("Warning: Index %1 out of range.").arg(index), 5000);
-        }
+void MainWindow::onUploadDateResolved(const QString &id, const QString &uploadDate) {
+    int row = channelModel->rowForId(id);
+    if (row < 0 || !channelListHasDates) {
+        return;
     }
+    QString date = uploadDate.left(4) + "-" + uploadDate.mid(4, 2) + "-" + uploadDate.right(2);
+    channelModel->setDate(row, date, true);
+    ChannelCache::updateDate(id, date);
+}
 
-    if (videoUrls.isEmpty()) {
-        consoleTextEdit->append("Error: No valid video URLs retrieved for selected indices.");
-        statusBar->showMessage("Error: No valid video URLs retrieved.", 5000);
-        downloadButton->setEnabled(true);
-        cancelButton->setVisible(false);
-        progressBar->setVisible(false);
-        downloadState = DownloadState::Idle;
-        emit downloadFinished();
-        if (urlFetchProcess) {
-            delete urlFetchProcess;
-            urlFetchProcess = nullptr;
-        }
+void MainWindow::flushChannelListBatch() {
+    if (pendingChannelData.isEmpty()) {
         return;
     }
+    channelModel->appendEntries(pendingChannelData);
+    pendingChannelData.clear();
+    updateVideoCountLabel();
+}
 
-    QString originalUrl = urlTextBox->text();
-    urlTextBox->setText(videoUrls.join(" "));
-    consoleTextEdit->append(QString("Initiating download for %1 item%2: %3")
-    .arg(videoUrls.size())
-    .arg(videoUrls.size() == 1 ? "" : "s")
-    .arg(videoUrls.join(", ")));
-    connect(this, &MainWindow::downloadFinished, this, [this, originalUrl]() {
-        urlTextBox->setText(originalUrl);
-    }, Qt::SingleShotConnection);
-
-    if (urlFetchProcess) {
-        delete urlFetchProcess;
-        urlFetchProcess = nullptr;
+void MainWindow::updateVideoCountLabel() {
+    if (channelFilterModel->isFiltering()) {
+        videoCountLabel->setText(QString("%1 of %2 listed").arg(channelFilterModel->rowCount()).arg(channelModel->entryCount()));
+    } else {
+        videoCountLabel->setText(QString("%1 listed").arg(channelModel->entryCount()));
     }
-    channelOutput.clear();
+}
 
-    startDownload();
+void MainWindow::setListStatus(QLabel *label, const QString &text, bool isError) {
+    label->setText(text);
+    label->setStyleSheet(isError ? "QLabel { color: red; }" : "QLabel { color: gray; }");
 }
 
-void MainWindow::updateUseSelectedChannelCheck() {
-    bool hasChecked = false;
-    for (int i = 0; i < channelListWidget->count(); ++i) {
-        QListWidgetItem *item = channelListWidget->item(i);
-        if (item->flags() & Qt::ItemIsUserCheckable && item->checkState() == Qt::Checked) {
-            hasChecked = true;
-            break;
+void MainWindow::onPlaylistSearchTextChanged(const QString &text) {
+    playlistFilterModel->setFilterText(text);
+}
+
+void MainWindow::onChannelSearchTextChanged(const QString &text) {
+    channelFilterModel->setFilterText(text);
+    updateVideoCountLabel();
+}
+
+// Bit i is the video at playlist index i + 1, runs of set bits become "a-b" ranges
+QString MainWindow::generatePlaylistItems(const QBitArray& selection) {
+    QStringList items;
+    int size = selection.size();
+    int i = 0;
+    while (i < size) {
+        if (!selection.testBit(i)) {
+            ++i;
+            continue;
+        }
+        int start = i;
+        while (i + 1 < size && selection.testBit(i + 1)) {
+            ++i;
+        }
+        if (start == i) {
+            items << QString::number(start + 1);
+        } else {
+            items << QString("%1-%2").arg(start + 1).arg(i + 1);
         }
+        ++i;
     }
-    useSelectedChannelItemsCheck->setChecked(hasChecked);
+    return items.join(",");
+}
+
+void MainWindow::updateUseSelectedChannelCheck() {
+    useSelectedChannelItemsCheck->setChecked(channelModel->hasChecked());
 }
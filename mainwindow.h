@@ -19,6 +19,21 @@
 #include <QPushButton>
 #include <QVector>
 #include <QPair>
+#include <QHash>
+#include <QBitArray>
+#include <QStyledItemDelegate>
+#include "downloadqueue.h"
+#include "downloadoptions.h"
+#include "consoleview.h"
+#include "updatecoalescer.h"
+#include "videolistmodel.h"
+#include "helperprocesses.h"
+#include "uploaddateresolver.h"
+#include "metadataprefetcher.h"
+#include "formatfetcher.h"
+#include "channelcache.h"
+#include "urlclassifier.h"
+#include "downloadarchive.h"
 
 class QLineEdit;
 class QPushButton;
@@ -29,6 +44,22 @@ class QSlider;
 class QLabel;
 class QProgressBar;
 class QTextEdit;
+class QSpinBox;
+class QTimer;
+class QListView;
+
+class ProgressBarDelegate : public QStyledItemDelegate {
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+// Sorts by the number in Qt::UserRole instead of the displayed text
+class SortableTableItem : public QTableWidgetItem {
+public:
+    SortableTableItem(const QString &text, double sortKey);
+    bool operator<(const QTableWidgetItem &other) const override;
+};
 
 class BookmarkDialog : public QDialog {
     Q_OBJECT
@@ -65,21 +96,28 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
     Q_SIGNAL void downloadFinished();
-    QString generatePlaylistItems(const QList<int>& indices);
+    static QString generatePlaylistItems(const QBitArray& selection);
 
 private slots:
     void onSelectFolderClicked();
     void onDownloadClicked();
+    void onImportUrlsClicked();
     void onCancelClicked();
-    void onCancelCleanup();
-    void onProcessOutput();
+    void onQueueJobAdded(int id);
+    void onQueueFrame(const QList<int> &dirtyJobs);
+    void onQueueJobFinished(int id);
+    void onQueueJobRemoved(int id);
+    void onQueueJobOutput(int id, const QString &text);
+    void onQueueContextMenuRequested(const QPoint &pos);
+    void onCancelSelectedJobsClicked();
+    void onRetrySelectedJobsClicked();
     void onUseCookiesFileToggled(bool checked);
     void onExtractCookiesFromBrowserToggled(bool checked);
     void onBrowseCookiesFileClicked();
     void updateCommandPreview();
     void onSaveConfigClicked();
     void onListFormatsClicked();
-    void startDownload();
+    void startDownload(const QStringList &urls = QStringList());
     void onRegexComboBoxChanged(int index);
     void onListPlaylistClicked();
     void onListChannelClicked();
@@ -90,16 +128,38 @@ private slots:
     void onBookmarkTableSelectionChanged();
     void onRemoveBookmarkClicked();
     void onEditBookmarkClicked();
-    void onUrlFetchFinished(int exitCode, QProcess::ExitStatus exitStatus);
 
 private:
-    static const int OriginalIndexRole = Qt::UserRole + 1;
     void setupUi();
-    QStringList buildCommand();
-    QStringList getSelectedChannelVideoUrls(const QString& channelUrl, const QString& endpoint, const QList<int>& indices);
-
-    enum class DownloadState { Idle, Downloading, PostProcessing };
-    DownloadState downloadState = DownloadState::Idle;
+    QStringList buildCommand(const QStringList &urlOverride = QStringList());
+    // urlInfo is the first URL in the URL box, classified by the caller
+    DownloadOptions currentOptions(const UrlInfo &urlInfo) const;
+    DownloadOptionsSnapshot optionsFor(const QStringList &urlOverride) const;
+    QString finalOutputDirectory() const;
+    bool prepareOutputDirectory();
+    void prefetchAhead();
+    void onMetadataReady(const QString &url, const QString &title);
+    void onMetadataUnavailable(const QString &url, const QString &reason);
+    void onFormatsReady(const QString &url, const VideoFormats &formats);
+    void onFormatsFailed(const QString &url, const QString &error);
+    void showFormats(const QString &url);
+    QList<int> selectedQueueJobs() const;
+    void refreshQueueRow(int id);
+    void updateQueueProgress();
+    // Newest entries fetched when checking a saved channel listing for new videos
+    static constexpr int ChannelRefreshSize = 30;
+    static VideoEntry parseChannelListLine(const QString &line);
+    static QStringList channelListArgs(const QString &fullUrl, int limit, bool refresh);
+    void scheduleChannelListing();
+    void stopChannelListing();
+    void startChannelListing(const QString &fullUrl, const QString &contentType, int limit, bool refresh);
+    void addChannelListLine(const QString &line, bool refresh);
+    void finishChannelRefresh(const QString &fullUrl, const QString &contentType, int limit, bool listEnded);
+    void flushChannelListBatch();
+    void updateVideoCountLabel();
+    void resolveVisibleDates();
+    void onUploadDateResolved(const QString &id, const QString &uploadDate);
+    void setListStatus(QLabel *label, const QString &text, bool isError = false);
     void initializeDatabase();
     void loadBookmarks();
 
@@ -110,7 +170,8 @@ private:
     QPushButton *downloadButton;
     QPushButton *cancelButton;
     QProgressBar *progressBar;
-    QTextEdit *consoleTextEdit;
+    ConsoleView *consoleTextEdit;
+    QSpinBox *consoleMaxLinesSpinBox;
     QLineEdit *usernameTextBox;
     QLineEdit *passwordTextBox;
     // Cookies File
@@ -186,42 +247,72 @@ private:
 
     // Playlist Tab
     QPushButton *listPlaylistButton;
-    QListWidget *playlistListWidget;
+    QListView *playlistListView;
+    VideoListModel *playlistModel;
+    VideoFilterModel *playlistFilterModel;
+    QLabel *playlistStatusLabel;
     QString playlistOutput;
     QCheckBox *useSelectedItemsCheck;
     QLineEdit *playlistSearchTextBox;
-    QStringList originalPlaylistTitles;
+    QTimer *playlistSearchTimer;
 
     // Channel Browser Tab
     QPushButton *listChannelButton;
-    QListWidget *channelListWidget;
-    QString channelOutput;
+    QPushButton *stopListChannelButton;
+    QTimer *channelListTimer;
+    QListView *channelListView;
+    VideoListModel *channelModel;
+    VideoFilterModel *channelFilterModel;
+    QLabel *channelStatusLabel;
+    DownloadOptionsSnapshot downloadOptions;
+    HelperProcessRegistry *helperProcesses;
+    MetadataPrefetcher *metadataPrefetcher;
+    QHash<QString, int> prefetchJobs;
+    // Jobs the user retried by hand, the prefetcher's verdict doesn't skip them again
+    QSet<int> retriedJobs;
+    QSet<QString> bookmarkUrls;
+    DownloadArchive channelArchive;
+    static constexpr int PrefetchAhead = 24;
+    QProcess *channelListProcess;
+    OutputParser channelListParser;
+    QVector<VideoEntry> pendingChannelData;
+    QVector<VideoEntry> refreshEntries;
+    bool channelRefreshHitKnown = false;
+    QTimer *channelListBatchTimer;
     QCheckBox *useSelectedChannelItemsCheck;
     QComboBox *channelContentComboBox;
     QLineEdit *channelSearchTextBox;
+    QTimer *channelSearchTimer;
     QComboBox *listLimitComboBox;
     QTableWidget *bookmarksTable;
     QCheckBox *showUploadDatesCheck;
     QLabel *videoCountLabel;
+    UploadDateResolver *dateResolver;
+    QTimer *dateResolveTimer;
+    bool channelListHasDates = false;
 
     // List Formats Tab
     QPushButton *listFormatsButton;
-    QTextEdit *formatsTextEdit;
+    QPushButton *refreshFormatsButton;
+    QComboBox *formatsUrlComboBox;
+    QLabel *formatsStatusLabel;
+    QTableWidget *formatsTable;
+    FormatFetcher *formatFetcher;
+    QHash<QString, QString> formatErrors;
     QLineEdit *selectedFormatCodeTextBox;
     QCheckBox *useQuickFormatsCheck;
     QComboBox *quickFormatsComboBox;
 
-    // More Stuff
-    QProcess *process;
-    QProcess *urlFetchProcess;
-    QStringList filesToDelete;
-    QDateTime downloadStartTime;
-    QVector<QPair<QString, QString>> originalChannelData;
-    QString channelUrl;
-    QString endpoint;
-    QList<int> indices;
-    int fetchAttempt;
-    int maxRetries;
+    // Download Queue Tab
+    DownloadQueue *downloadQueue;
+    WorkerPool *workerPool;
+    CookieManager *cookieManager;
+    QTableWidget *queueTable;
+    QSpinBox *maxWorkersSpinBox;
+    QCheckBox *pythonWorkersCheck;
+    QHash<int, QTableWidgetItem*> queueItems;
+    UpdateCoalescer *queueUpdates;
+    QLabel *updateStatsLabel;
 
     QCheckBox *useAria2cCheck;
     QComboBox *aria2cOptionsCombo;
@@ -0,0 +1,128 @@
+#include "metadataprefetcher.h"
+#include "urlclassifier.h"
+#include "infojsonstore.h"
+
+// URLs per yt-dlp run
+static const int BatchSize = 8;
+
+// Errors that won't go away by trying again, anything else is left for the download to retry
+static bool isPermanentError(const QString &message) {
+    return message.contains("Video unavailable", Qt::CaseInsensitive)
+        || message.contains("Private video", Qt::CaseInsensitive)
+        || message.contains("has been removed", Qt::CaseInsensitive)
+        || message.contains("account associated with this video has been terminated", Qt::CaseInsensitive);
+}
+
+MetadataPrefetcher::MetadataPrefetcher(HelperProcessRegistry *registry, QObject *parent) : QObject(parent), registry(registry) {
+}
+
+void MetadataPrefetcher::request(const QStringList &urls) {
+    for (const QString &url : urls) {
+        if (url.isEmpty() || inFlight.contains(url)) {
+            continue;
+        }
+        auto title = titles.constFind(url);
+        if (title != titles.constEnd()) {
+            emit metadataReady(url, title.value());
+            continue;
+        }
+        auto reason = unavailableReasons.constFind(url);
+        if (reason != unavailableReasons.constEnd()) {
+            emit unavailable(url, reason.value());
+            continue;
+        }
+        inFlight.insert(url);
+        queue.append(url);
+    }
+    startNext();
+}
+
+void MetadataPrefetcher::clearPending() {
+    for (const QString &url : std::as_const(queue)) {
+        inFlight.remove(url);
+    }
+    queue.clear();
+}
+
+void MetadataPrefetcher::setMaxProcesses(int count) {
+    processLimit = qMax(1, count);
+    startNext();
+}
+
+int MetadataPrefetcher::maxProcesses() const {
+    return processLimit;
+}
+
+bool MetadataPrefetcher::isKnown(const QString &url) const {
+    return titles.contains(url) || unavailableReasons.contains(url);
+}
+
+void MetadataPrefetcher::startNext() {
+    while (processes.size() < processLimit && !queue.isEmpty()) {
+        QStringList urls;
+        // --print alone would imply --simulate, which writes no info JSON
+        QStringList args = {"--skip-download", "--no-simulate", "--ignore-errors", "--no-warnings", "--no-playlist",
+                            "--write-info-json", "--no-write-playlist-metafiles", "-o", InfoJsonStore::outputTemplate(),
+                            "--print", "%(original_url)s\t%(title)s"};
+        while (!queue.isEmpty() && urls.size() < BatchSize) {
+            urls << queue.takeFirst();
+        }
+        args += urls;
+        QProcess *process = registry->request("metadata", args, false);
+        processes.append(process);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process, urls]() {
+            onBatchFinished(process, urls);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, process, urls](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                onBatchFinished(process, urls);
+            }
+        });
+    }
+}
+
+void MetadataPrefetcher::onBatchFinished(QProcess *process, const QStringList &urls) {
+    if (!processes.removeOne(process)) {
+        return;
+    }
+    const QStringList lines = QString::fromUtf8(process->readAllStandardOutput()).split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        qsizetype tab = line.indexOf('\t');
+        if (tab < 0) {
+            continue;
+        }
+        QString url = line.left(tab);
+        QString title = line.mid(tab + 1).trimmed();
+        if (inFlight.contains(url) && !title.isEmpty() && title != "NA") {
+            titles.insert(url, title);
+            emit metadataReady(url, title);
+        }
+    }
+    // yt-dlp names the video id in its errors ("ERROR: [youtube] <id>: Video unavailable")
+    QHash<QString, QString> urlsById;
+    for (const QString &url : urls) {
+        if (!titles.contains(url)) {
+            urlsById.insert(UrlClassifier::classify(url).videoId, url);
+        }
+    }
+    const QStringList errors = QString::fromUtf8(process->readAllStandardError()).split('\n', Qt::SkipEmptyParts);
+    for (const QString &error : errors) {
+        if (!error.startsWith("ERROR:") || !isPermanentError(error)) {
+            continue;
+        }
+        for (auto it = urlsById.constBegin(); it != urlsById.constEnd(); ++it) {
+            if (!it.key().isEmpty() && error.contains(it.key() + ":")) {
+                QString reason = error.section(": ", -1).trimmed();
+                unavailableReasons.insert(it.value(), reason);
+                emit unavailable(it.value(), reason);
+                break;
+            }
+        }
+    }
+    // Whatever didn't come back is left alone, the download itself will find out
+    for (const QString &url : urls) {
+        inFlight.remove(url);
+    }
+    process->deleteLater();
+    startNext();
+}
@@ -0,0 +1,46 @@
+#ifndef METADATAPREFETCHER_H
+#define METADATAPREFETCHER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QStringList>
+#include "helperprocesses.h"
+
+// Looks up titles for queued single-video URLs before their download
+// starts, and notices videos that are gone (removed, private) so they can
+// be skipped instead of failing. A few URLs per yt-dlp run, at most
+// maxProcesses() runs at once, answers are cached by URL. Each lookup
+// also leaves the video's info JSON in the InfoJsonStore.
+class MetadataPrefetcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit MetadataPrefetcher(HelperProcessRegistry *registry, QObject *parent = nullptr);
+
+    void request(const QStringList &urls);
+    void clearPending();
+    void setMaxProcesses(int count);
+    int maxProcesses() const;
+    bool isKnown(const QString &url) const;
+
+signals:
+    void metadataReady(const QString &url, const QString &title);
+    void unavailable(const QString &url, const QString &reason);
+
+private:
+    void startNext();
+    void onBatchFinished(QProcess *process, const QStringList &urls);
+
+    HelperProcessRegistry *registry;
+    QHash<QString, QString> titles;
+    QHash<QString, QString> unavailableReasons;
+    QStringList queue;
+    QSet<QString> inFlight;
+    QList<QProcess*> processes;
+    int processLimit = 2;
+};
+
+#endif // METADATAPREFETCHER_H
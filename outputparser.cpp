@@ -0,0 +1,207 @@
+#include "outputparser.h"
+
+// Fields of the machine readable progress line, in order
+enum ProgressField { DownloadedBytes, TotalBytes, SpeedBytes, EtaSeconds, FragmentIndex, FragmentCount, ProgressFieldCount };
+
+QVector<OutputEvent> OutputParser::feed(const QByteArray &chunk) {
+    QVector<OutputEvent> events;
+    // Whatever is already buffered has no line break in it, so only scan the new bytes
+    qsizetype scanFrom = buffer.size();
+    buffer.append(chunk);
+    qsizetype lineStart = 0;
+    for (qsizetype i = scanFrom; i < buffer.size(); ++i) {
+        char c = buffer.at(i);
+        if (c != '\n' && c != '\r') {
+            continue;
+        }
+        if (i > lineStart) {
+            QString line = QString::fromUtf8(buffer.constData() + lineStart, i - lineStart);
+            if (!line.trimmed().isEmpty()) {
+                events.append(parseLine(line));
+            }
+        }
+        lineStart = i + 1;
+    }
+    buffer.remove(0, lineStart);
+    return events;
+}
+
+QVector<OutputEvent> OutputParser::flush() {
+    QVector<OutputEvent> events;
+    QString line = QString::fromUtf8(buffer);
+    buffer.clear();
+    if (!line.trimmed().isEmpty()) {
+        events.append(parseLine(line));
+    }
+    return events;
+}
+
+OutputEvent OutputParser::parseLine(const QString &line) {
+    OutputEvent event;
+    event.line = line;
+    QStringView view = QStringView(line).trimmed();
+    if (view.startsWith(QLatin1String("ERROR:"))) {
+        event.type = OutputEvent::Type::Error;
+        return event;
+    }
+    if (!view.startsWith(u'[')) {
+        return event;
+    }
+    qsizetype close = view.indexOf(u']');
+    if (close < 0) {
+        return event;
+    }
+    QStringView tag = view.mid(1, close - 1);
+    QStringView rest = view.mid(close + 1).trimmed();
+
+    if (tag == QLatin1String("ytdlpf")) {
+        parseProgressTemplate(rest, event);
+    } else if (tag.startsWith(u'#')) {
+        parseAria2cProgress(view, event);
+    } else if (tag == QLatin1String("download")) {
+        if (rest.startsWith(QLatin1String("Destination:"))) {
+            event.type = OutputEvent::Type::Destination;
+            event.path = rest.mid(12).trimmed().toString();
+        } else {
+            parseDownloadProgress(rest, event);
+        }
+    } else if (tag == QLatin1String("Merger")) {
+        const QLatin1String mergePrefix("Merging formats into");
+        if (rest.startsWith(mergePrefix)) {
+            event.type = OutputEvent::Type::Merger;
+            event.path = rest.mid(mergePrefix.size()).trimmed().toString().remove('"');
+        } else {
+            event.type = OutputEvent::Type::PostProcessor;
+        }
+    } else if (isPostProcessorTag(tag)) {
+        event.type = OutputEvent::Type::PostProcessor;
+    }
+    return event;
+}
+
+// Handed to yt-dlp with --newline so every progress update is one line of
+// '|' separated numbers (NA when yt-dlp doesn't know a value)
+QString OutputParser::progressTemplate() {
+    return "download:[ytdlpf] "
+           "%(progress.downloaded_bytes)s|"
+           "%(progress.total_bytes,progress.total_bytes_estimate)s|"
+           "%(progress.speed)s|"
+           "%(progress.eta)s|"
+           "%(progress.fragment_index)s|"
+           "%(progress.fragment_count)s";
+}
+
+// [ytdlpf] 1048576|52428800|2097152.5|25|NA|NA
+void OutputParser::parseProgressTemplate(QStringView rest, OutputEvent &event) {
+    QStringView fields[ProgressFieldCount];
+    int count = 0;
+    qsizetype fieldStart = 0;
+    for (qsizetype i = 0; i <= rest.size() && count < ProgressFieldCount; ++i) {
+        if (i == rest.size() || rest.at(i) == u'|') {
+            fields[count++] = rest.mid(fieldStart, i - fieldStart);
+            fieldStart = i + 1;
+        }
+    }
+    if (count < ProgressFieldCount) {
+        return;
+    }
+    auto number = [&fields](int field) {
+        bool ok = false;
+        double value = fields[field].toDouble(&ok);
+        return ok ? value : -1.0;
+    };
+    event.type = OutputEvent::Type::Progress;
+    event.downloadedBytes = number(DownloadedBytes);
+    event.totalBytes = number(TotalBytes);
+    event.speedBytes = number(SpeedBytes);
+    event.etaSeconds = number(EtaSeconds);
+    event.fragmentIndex = static_cast<int>(number(FragmentIndex));
+    event.fragmentCount = static_cast<int>(number(FragmentCount));
+    if (event.downloadedBytes >= 0 && event.totalBytes > 0) {
+        event.percent = qMin(100.0, event.downloadedBytes * 100.0 / event.totalBytes);
+    } else if (event.fragmentIndex >= 0 && event.fragmentCount > 0) {
+        event.percent = qMin(100.0, event.fragmentIndex * 100.0 / event.fragmentCount);
+    }
+}
+
+// [download]  12.3% of ~  50.00MiB at    2.00MiB/s ETA 00:20 (frag 3/10)
+void OutputParser::parseDownloadProgress(QStringView rest, OutputEvent &event) {
+    qsizetype percentSign = rest.indexOf(u'%');
+    if (percentSign <= 0) {
+        return;
+    }
+    bool ok = false;
+    double percent = rest.left(percentSign).toDouble(&ok);
+    if (!ok) {
+        return;
+    }
+    event.type = OutputEvent::Type::Progress;
+    event.percent = percent;
+    event.speed = tokenAfter(rest, QLatin1String(" at ")).toString();
+    event.eta = tokenAfter(rest, QLatin1String("ETA ")).toString();
+}
+
+// [#2089b0 400.0KiB/33.2MiB(1%) CN:1 DL:115.7KiB ETA:4m51s]
+void OutputParser::parseAria2cProgress(QStringView line, OutputEvent &event) {
+    qsizetype open = line.indexOf(u'(');
+    if (open < 0) {
+        return;
+    }
+    qsizetype close = line.indexOf(QLatin1String("%)"), open);
+    if (close <= open + 1) {
+        return;
+    }
+    bool ok = false;
+    double percent = line.mid(open + 1, close - open - 1).toDouble(&ok);
+    if (!ok) {
+        return;
+    }
+    event.type = OutputEvent::Type::Progress;
+    event.percent = percent;
+    event.speed = tokenAfter(line, QLatin1String("DL:")).toString();
+    event.eta = tokenAfter(line, QLatin1String("ETA:")).toString();
+}
+
+bool OutputParser::isPostProcessorTag(QStringView tag) {
+    static const QLatin1String postProcessorTags[] = {
+        QLatin1String("ffmpeg"),
+        QLatin1String("Metadata"),
+        QLatin1String("SponsorBlock"),
+        QLatin1String("ModifyChapters"),
+        QLatin1String("EmbedSubtitle"),
+        QLatin1String("EmbedThumbnail"),
+        QLatin1String("ExtractAudio"),
+        QLatin1String("VideoConvertor"),
+        QLatin1String("VideoRemuxer"),
+        QLatin1String("ThumbnailsConvertor"),
+        QLatin1String("SplitChapters"),
+        QLatin1String("MoveFiles"),
+        QLatin1String("FixupM3u8"),
+        QLatin1String("FixupM4a"),
+        QLatin1String("FixupStretched"),
+        QLatin1String("FixupDuplicateMoov"),
+        QLatin1String("FixupTimestamp")
+    };
+    for (const QLatin1String &known : postProcessorTags) {
+        if (tag.compare(known, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QStringView OutputParser::tokenAfter(QStringView text, QLatin1String marker) {
+    qsizetype markerPos = text.indexOf(marker);
+    if (markerPos < 0) {
+        return QStringView();
+    }
+    qsizetype start = markerPos + marker.size();
+    while (start < text.size() && text.at(start).isSpace()) {
+        start++;
+    }
+    qsizetype end = start;
+    while (end < text.size() && !text.at(end).isSpace() && text.at(end) != u']') {
+        end++;
+    }
+    return text.mid(start, end - start);
+}
@@ -0,0 +1,46 @@
+#ifndef OUTPUTPARSER_H
+#define OUTPUTPARSER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+struct OutputEvent {
+    enum class Type { Line, Destination, Merger, Progress, PostProcessor, Error };
+
+    Type type = Type::Line;
+    QString line;
+    QString path;
+    double percent = -1.0;
+    QString speed;
+    QString eta;
+    double downloadedBytes = -1.0;
+    double totalBytes = -1.0;
+    double speedBytes = -1.0;
+    double etaSeconds = -1.0;
+    int fragmentIndex = -1;
+    int fragmentCount = -1;
+};
+
+// Frames yt-dlp output into lines as it arrives (both \n and the \r used for
+// progress redraws end a line) and classifies each line by its [tag] prefix.
+// A partial line stays buffered until the rest of it shows up.
+class OutputParser {
+public:
+    QVector<OutputEvent> feed(const QByteArray &chunk);
+    QVector<OutputEvent> flush();
+    static OutputEvent parseLine(const QString &line);
+    static QString progressTemplate();
+
+private:
+    static void parseProgressTemplate(QStringView rest, OutputEvent &event);
+    static void parseDownloadProgress(QStringView rest, OutputEvent &event);
+    static void parseAria2cProgress(QStringView line, OutputEvent &event);
+    static bool isPostProcessorTag(QStringView tag);
+    static QStringView tokenAfter(QStringView text, QLatin1String marker);
+
+    QByteArray buffer;
+};
+
+#endif // OUTPUTPARSER_H
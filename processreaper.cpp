@@ -0,0 +1,33 @@
+#include "processreaper.h"
+#include <QSet>
+#include <QTimer>
+
+static QSet<QProcess*> &stopping() {
+    static QSet<QProcess*> processes;
+    return processes;
+}
+
+void ProcessReaper::stop(QProcess *process, int graceMs) {
+    if (!process || stopping().contains(process)) {
+        return;
+    }
+    process->disconnect();
+    process->setParent(nullptr);
+    if (process->state() == QProcess::NotRunning) {
+        process->deleteLater();
+        return;
+    }
+    stopping().insert(process);
+    QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), process, [process]() {
+        stopping().remove(process);
+        process->deleteLater();
+    });
+    process->terminate();
+    QTimer::singleShot(graceMs, process, [process]() {
+        process->kill();
+    });
+}
+
+int ProcessReaper::pendingCount() {
+    return stopping().size();
+}
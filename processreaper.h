@@ -0,0 +1,20 @@
+#ifndef PROCESSREAPER_H
+#define PROCESSREAPER_H
+
+#include <QProcess>
+
+// Stops processes without waiting for them. terminate() first so yt-dlp
+// gets to clean up, kill() once the grace period is over, and the QProcess
+// is only deleted after it has exited, because deleting a running QProcess
+// blocks until it's gone.
+class ProcessReaper {
+public:
+    static constexpr int DefaultGraceMs = 3000;
+
+    // Takes the process over: its signals are disconnected and it no longer
+    // belongs to its parent, so the parent can be destroyed right away.
+    static void stop(QProcess *process, int graceMs = DefaultGraceMs);
+    static int pendingCount();
+};
+
+#endif // PROCESSREAPER_H
@@ -0,0 +1,57 @@
+#include "retryscheduler.h"
+#include <QRandomGenerator>
+
+RetryScheduler::RetryScheduler(int baseDelayMs, int maxDelayMs, QObject *parent) : QObject(parent), baseDelay(qMax(1, baseDelayMs)), maxDelay(qMax(baseDelayMs, maxDelayMs)) {
+}
+
+RetryScheduler::~RetryScheduler() {
+    cancelAll();
+}
+
+int RetryScheduler::delayFor(int attempt) const {
+    qint64 delay = baseDelay;
+    for (int i = 1; i < attempt && delay < maxDelay; ++i) {
+        delay *= 2;
+    }
+    delay = qMin<qint64>(delay, maxDelay);
+    return static_cast<int>(delay + QRandomGenerator::global()->bounded(static_cast<int>(delay / 2) + 1));
+}
+
+int RetryScheduler::schedule(int key, int attempt) {
+    cancel(key);
+    int delay = delayFor(attempt);
+    QTimer *timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, [this, key, timer]() {
+        timers.remove(key);
+        timer->deleteLater();
+        emit due(key);
+    });
+    timers.insert(key, timer);
+    timer->start(delay);
+    return delay;
+}
+
+void RetryScheduler::cancel(int key) {
+    QTimer *timer = timers.take(key);
+    if (timer) {
+        timer->stop();
+        timer->deleteLater();
+    }
+}
+
+void RetryScheduler::cancelAll() {
+    for (QTimer *timer : std::as_const(timers)) {
+        timer->stop();
+        timer->deleteLater();
+    }
+    timers.clear();
+}
+
+bool RetryScheduler::isPending(int key) const {
+    return timers.contains(key);
+}
+
+bool RetryScheduler::hasPending() const {
+    return !timers.isEmpty();
+}
@@ -0,0 +1,36 @@
+#ifndef RETRYSCHEDULER_H
+#define RETRYSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+
+// Waits before trying something again without ever blocking the event
+// loop. The wait doubles with every attempt (up to maxDelay) and gets a
+// random extra of up to half of it, so things that failed together don't
+// all come back at the same moment.
+class RetryScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RetryScheduler(int baseDelayMs = 2000, int maxDelayMs = 60000, QObject *parent = nullptr);
+    ~RetryScheduler();
+
+    // attempt is 1 for the first retry
+    int schedule(int key, int attempt);
+    void cancel(int key);
+    void cancelAll();
+    bool isPending(int key) const;
+    bool hasPending() const;
+    int delayFor(int attempt) const;
+
+signals:
+    void due(int key);
+
+private:
+    QHash<int, QTimer*> timers;
+    int baseDelay;
+    int maxDelay;
+};
+
+#endif // RETRYSCHEDULER_H
@@ -0,0 +1,90 @@
+#include "titleindex.h"
+#include <algorithm>
+
+void TitleIndex::add(const QString &title) {
+    int id = offsets.size();
+    offsets.append(buffer.size());
+    QString folded = fold(title);
+    buffer += folded;
+    // Separator so no trigram or match spans two titles
+    buffer += QChar(0);
+    QStringView view(folded);
+    for (qsizetype i = 0; i + 3 <= view.size(); ++i) {
+        QVector<int> &list = postings[trigramKey(view, i)];
+        if (list.isEmpty() || list.last() != id) {
+            list.append(id);
+        }
+    }
+}
+
+void TitleIndex::clear() {
+    buffer.clear();
+    offsets.clear();
+    postings.clear();
+}
+
+int TitleIndex::size() const {
+    return offsets.size();
+}
+
+QString TitleIndex::fold(const QString &text) {
+    return text.trimmed().toCaseFolded();
+}
+
+bool TitleIndex::matches(int id, const QString &foldedQuery) const {
+    return title(id).contains(foldedQuery);
+}
+
+QVector<int> TitleIndex::search(const QString &foldedQuery) const {
+    QVector<int> result;
+    if (foldedQuery.size() < 3) {
+        for (int id = 0; id < offsets.size(); ++id) {
+            if (matches(id, foldedQuery)) {
+                result.append(id);
+            }
+        }
+        return result;
+    }
+    // Start from the rarest trigram and keep only ids present in all of them
+    QStringView query(foldedQuery);
+    QVector<const QVector<int>*> lists;
+    for (qsizetype i = 0; i + 3 <= query.size(); ++i) {
+        auto it = postings.constFind(trigramKey(query, i));
+        if (it == postings.constEnd()) {
+            return result;
+        }
+        lists.append(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](const QVector<int> *a, const QVector<int> *b) {
+        return a->size() < b->size();
+    });
+    QVector<int> candidates = *lists.first();
+    QVector<int> intersected;
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        intersected.clear();
+        std::set_intersection(candidates.cbegin(), candidates.cend(), lists.at(i)->cbegin(), lists.at(i)->cend(), std::back_inserter(intersected));
+        candidates.swap(intersected);
+    }
+    // Having every trigram doesn't mean having them in order
+    return narrow(candidates, foldedQuery);
+}
+
+QVector<int> TitleIndex::narrow(const QVector<int> &candidates, const QString &foldedQuery) const {
+    QVector<int> result;
+    for (int id : candidates) {
+        if (matches(id, foldedQuery)) {
+            result.append(id);
+        }
+    }
+    return result;
+}
+
+quint64 TitleIndex::trigramKey(QStringView text, qsizetype pos) {
+    return (quint64(text.at(pos).unicode()) << 32) | (quint64(text.at(pos + 1).unicode()) << 16) | quint64(text.at(pos + 2).unicode());
+}
+
+QStringView TitleIndex::title(int id) const {
+    int start = offsets.at(id);
+    int end = id + 1 < offsets.size() ? offsets.at(id + 1) - 1 : buffer.size() - 1;
+    return QStringView(buffer).mid(start, end - start);
+}
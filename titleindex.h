@@ -0,0 +1,33 @@
+#ifndef TITLEINDEX_H
+#define TITLEINDEX_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <QHash>
+
+// Substring search over a growing list of titles. Titles are case folded
+// once into a single buffer and every 3-character window is recorded in a
+// posting list, so a query only has to verify the titles that contain all
+// of its trigrams.
+class TitleIndex {
+public:
+    void add(const QString &title);
+    void clear();
+    int size() const;
+
+    static QString fold(const QString &text);
+    bool matches(int id, const QString &foldedQuery) const;
+    QVector<int> search(const QString &foldedQuery) const;
+    QVector<int> narrow(const QVector<int> &candidates, const QString &foldedQuery) const;
+
+private:
+    static quint64 trigramKey(QStringView text, qsizetype pos);
+    QStringView title(int id) const;
+
+    QString buffer;
+    QVector<int> offsets;
+    QHash<quint64, QVector<int>> postings;
+};
+
+#endif // TITLEINDEX_H
@@ -0,0 +1,44 @@
+#include "updatecoalescer.h"
+
+UpdateCoalescer::UpdateCoalescer(int framesPerSecond, QObject *parent) : QObject(parent) {
+    frameTimer.setInterval(1000 / qMax(1, framesPerSecond));
+    frameTimer.setSingleShot(true);
+    connect(&frameTimer, &QTimer::timeout, this, &UpdateCoalescer::emitFrame);
+}
+
+void UpdateCoalescer::markDirty(int key) {
+    dirty.insert(key);
+    markEvent();
+}
+
+void UpdateCoalescer::markEvent() {
+    events++;
+    eventPending = true;
+    // The timer only runs while there is something to paint
+    if (!frameTimer.isActive()) {
+        frameTimer.start();
+    }
+}
+
+int UpdateCoalescer::frameInterval() const {
+    return frameTimer.interval();
+}
+
+quint64 UpdateCoalescer::eventsReceived() const {
+    return events;
+}
+
+quint64 UpdateCoalescer::framesPainted() const {
+    return frames;
+}
+
+void UpdateCoalescer::emitFrame() {
+    if (!eventPending) {
+        return;
+    }
+    QList<int> keys = dirty.values();
+    dirty.clear();
+    eventPending = false;
+    frames++;
+    emit frame(keys);
+}
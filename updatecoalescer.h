@@ -0,0 +1,36 @@
+#ifndef UPDATECOALESCER_H
+#define UPDATECOALESCER_H
+
+#include <QObject>
+#include <QSet>
+#include <QList>
+#include <QTimer>
+
+// Collects "something changed" notifications and hands them out at most
+// once per frame, so the UI repaints at a fixed rate no matter how fast
+// the events come in.
+class UpdateCoalescer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit UpdateCoalescer(int framesPerSecond = 30, QObject *parent = nullptr);
+    void markDirty(int key);
+    void markEvent();
+    int frameInterval() const;
+    quint64 eventsReceived() const;
+    quint64 framesPainted() const;
+
+signals:
+    void frame(const QList<int> &dirtyKeys);
+
+private:
+    void emitFrame();
+
+    QSet<int> dirty;
+    bool eventPending = false;
+    quint64 events = 0;
+    quint64 frames = 0;
+    QTimer frameTimer;
+};
+
+#endif // UPDATECOALESCER_H
@@ -0,0 +1,99 @@
+#include "uploaddateresolver.h"
+
+// Videos per yt-dlp run, starting python is most of the cost for one video
+static const int BatchSize = 8;
+
+UploadDateResolver::UploadDateResolver(HelperProcessRegistry *registry, QObject *parent) : QObject(parent), registry(registry) {
+}
+
+void UploadDateResolver::request(const QList<QPair<QString, QString>> &videos) {
+    for (const QPair<QString, QString> &video : videos) {
+        if (video.first.isEmpty() || inFlight.contains(video.first)) {
+            continue;
+        }
+        auto cached = cache.constFind(video.first);
+        if (cached != cache.constEnd()) {
+            if (!cached.value().isEmpty()) {
+                emit dateResolved(video.first, cached.value());
+            }
+            continue;
+        }
+        inFlight.insert(video.first);
+        queue.append(video);
+    }
+    startNext();
+}
+
+void UploadDateResolver::clearPending() {
+    for (const QPair<QString, QString> &video : std::as_const(queue)) {
+        inFlight.remove(video.first);
+    }
+    queue.clear();
+}
+
+void UploadDateResolver::setMaxProcesses(int count) {
+    processLimit = qMax(1, count);
+    startNext();
+}
+
+int UploadDateResolver::maxProcesses() const {
+    return processLimit;
+}
+
+bool UploadDateResolver::isKnown(const QString &id) const {
+    return cache.contains(id);
+}
+
+void UploadDateResolver::startNext() {
+    while (processes.size() < processLimit && !queue.isEmpty()) {
+        QStringList ids;
+        QStringList args = {"--skip-download", "--ignore-errors", "--no-warnings", "--print", "%(id)s\t%(upload_date)s"};
+        while (!queue.isEmpty() && ids.size() < BatchSize) {
+            QPair<QString, QString> video = queue.takeFirst();
+            ids << video.first;
+            args << video.second;
+        }
+        // Batches differ, so these never supersede each other
+        QProcess *process = registry->request("upload-date", args, false);
+        processes.append(process);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process, ids]() {
+            onBatchFinished(process, ids);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, process, ids](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                onBatchFinished(process, ids);
+            }
+        });
+    }
+}
+
+void UploadDateResolver::onBatchFinished(QProcess *process, const QStringList &ids) {
+    if (!processes.removeOne(process)) {
+        return;
+    }
+    const QStringList lines = QString::fromUtf8(process->readAllStandardOutput()).split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        QStringList parts = line.trimmed().split('\t');
+        if (parts.size() < 2) {
+            continue;
+        }
+        QString id = parts.at(0);
+        QString date = parts.at(1).trimmed();
+        if (date.size() != 8 || date == "NA") {
+            date.clear();
+        }
+        cache.insert(id, date);
+        if (!date.isEmpty()) {
+            emit dateResolved(id, date);
+        }
+    }
+    // Whatever didn't come back is remembered as unknown, so it isn't fetched over and over
+    for (const QString &id : ids) {
+        inFlight.remove(id);
+        if (!cache.contains(id)) {
+            cache.insert(id, QString());
+        }
+    }
+    process->deleteLater();
+    startNext();
+}
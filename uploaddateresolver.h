@@ -0,0 +1,45 @@
+#ifndef UPLOADDATERESOLVER_H
+#define UPLOADDATERESOLVER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include "helperprocesses.h"
+
+// Looks up exact upload dates for single videos in the background.
+// Videos are batched a few per yt-dlp run, at most maxProcesses() runs
+// at once (on top of the registry's own cap), and every answer
+// (including "unknown") is cached by video id.
+class UploadDateResolver : public QObject {
+    Q_OBJECT
+
+public:
+    explicit UploadDateResolver(HelperProcessRegistry *registry, QObject *parent = nullptr);
+
+    // id, url pairs
+    void request(const QList<QPair<QString, QString>> &videos);
+    void clearPending();
+    void setMaxProcesses(int count);
+    int maxProcesses() const;
+    bool isKnown(const QString &id) const;
+
+signals:
+    void dateResolved(const QString &id, const QString &uploadDate);
+
+private:
+    void startNext();
+    void onBatchFinished(QProcess *process, const QStringList &ids);
+
+    HelperProcessRegistry *registry;
+    QHash<QString, QString> cache;
+    QList<QPair<QString, QString>> queue;
+    QSet<QString> inFlight;
+    QList<QProcess*> processes;
+    int processLimit = 3;
+};
+
+#endif // UPLOADDATERESOLVER_H
@@ -0,0 +1,134 @@
+#include "urlclassifier.h"
+#include <QStringView>
+
+static bool isYouTubeHost(QStringView host) {
+    if (host.startsWith(u"www.", Qt::CaseInsensitive)) {
+        host = host.mid(4);
+    } else if (host.startsWith(u"m.", Qt::CaseInsensitive)) {
+        host = host.mid(2);
+    }
+    if (host.compare(u"youtube.com", Qt::CaseInsensitive) == 0) {
+        return true;
+    }
+    // youtube.co.uk and friends
+    return host.size() == 13 && host.startsWith(u"youtube.co.", Qt::CaseInsensitive)
+        && host.at(11).isLetter() && host.at(12).isLetter();
+}
+
+static QStringView queryValue(QStringView query, QStringView key) {
+    while (!query.isEmpty()) {
+        qsizetype end = query.indexOf(u'&');
+        QStringView pair = end < 0 ? query : query.left(end);
+        if (pair.size() > key.size() && pair.startsWith(key) && pair.at(key.size()) == u'=') {
+            return pair.mid(key.size() + 1);
+        }
+        if (end < 0) {
+            break;
+        }
+        query = query.mid(end + 1);
+    }
+    return QStringView();
+}
+
+static QStringView nextSegment(QStringView &path) {
+    while (path.startsWith(u'/')) {
+        path = path.mid(1);
+    }
+    qsizetype end = path.indexOf(u'/');
+    QStringView segment = end < 0 ? path : path.left(end);
+    path = path.mid(segment.size());
+    return segment;
+}
+
+QString UrlInfo::channelName() const {
+    QString name = channelBase.section('/', -1);
+    return name.startsWith('@') ? name.mid(1) : name;
+}
+
+UrlInfo UrlClassifier::classify(const QString &url) {
+    UrlInfo info;
+    QStringView rest = QStringView(url).trimmed();
+    qsizetype schemeLength = 0;
+    if (rest.startsWith(u"https://", Qt::CaseInsensitive)) {
+        schemeLength = 8;
+    } else if (rest.startsWith(u"http://", Qt::CaseInsensitive)) {
+        schemeLength = 7;
+    } else {
+        return info;
+    }
+    QStringView full = rest;
+    rest = rest.mid(schemeLength);
+
+    qsizetype hostEnd = 0;
+    while (hostEnd < rest.size() && rest.at(hostEnd) != u'/' && rest.at(hostEnd) != u'?' && rest.at(hostEnd) != u'#') {
+        hostEnd++;
+    }
+    QStringView host = rest.left(hostEnd);
+    QStringView prefix = full.left(schemeLength + hostEnd);
+    rest = rest.mid(hostEnd);
+    qsizetype fragment = rest.indexOf(u'#');
+    if (fragment >= 0) {
+        rest = rest.left(fragment);
+    }
+    qsizetype queryStart = rest.indexOf(u'?');
+    QStringView path = queryStart < 0 ? rest : rest.left(queryStart);
+    QStringView query = queryStart < 0 ? QStringView() : rest.mid(queryStart + 1);
+
+    QStringView first = nextSegment(path);
+    if (host.compare(u"youtu.be", Qt::CaseInsensitive) == 0) {
+        if (!first.isEmpty()) {
+            info.kind = UrlInfo::Kind::Video;
+            info.videoId = first.toString();
+        }
+        return info;
+    }
+    if (!isYouTubeHost(host) || first.isEmpty()) {
+        return info;
+    }
+
+    if (first.startsWith(u'@') && first.size() > 1) {
+        info.kind = UrlInfo::Kind::Channel;
+        info.channelBase = prefix.toString() + '/' + first.toString();
+        return info;
+    }
+    if (first.compare(u"c", Qt::CaseInsensitive) == 0 || first.compare(u"channel", Qt::CaseInsensitive) == 0
+        || first.compare(u"user", Qt::CaseInsensitive) == 0) {
+        QStringView name = nextSegment(path);
+        if (!name.isEmpty()) {
+            info.kind = UrlInfo::Kind::Channel;
+            info.channelBase = prefix.toString() + '/' + first.toString() + '/' + name.toString();
+        }
+        return info;
+    }
+    if (first.compare(u"playlist", Qt::CaseInsensitive) == 0) {
+        QStringView list = queryValue(query, u"list");
+        if (!list.isEmpty()) {
+            info.kind = UrlInfo::Kind::Playlist;
+            info.playlistId = list.toString();
+        }
+        return info;
+    }
+    if (first.compare(u"watch", Qt::CaseInsensitive) == 0) {
+        QStringView video = queryValue(query, u"v");
+        QStringView list = queryValue(query, u"list");
+        if (!video.isEmpty()) {
+            info.kind = list.isEmpty() ? UrlInfo::Kind::Video : UrlInfo::Kind::Playlist;
+            info.videoId = video.toString();
+            info.playlistId = list.toString();
+        }
+        return info;
+    }
+    QStringView id = nextSegment(path);
+    if (id.isEmpty()) {
+        return info;
+    }
+    if (first.compare(u"shorts", Qt::CaseInsensitive) == 0) {
+        info.kind = UrlInfo::Kind::Short;
+        info.videoId = id.toString();
+    } else if (first.compare(u"live", Qt::CaseInsensitive) == 0 || first.compare(u"embed", Qt::CaseInsensitive) == 0
+               || first.compare(u"v", Qt::CaseInsensitive) == 0) {
+        info.kind = UrlInfo::Kind::Video;
+        info.videoId = id.toString();
+    }
+    return info;
+}
@@ -0,0 +1,28 @@
+#ifndef URLCLASSIFIER_H
+#define URLCLASSIFIER_H
+
+#include <QString>
+
+struct UrlInfo {
+    enum class Kind { Other, Video, Playlist, Channel, Short };
+
+    Kind kind = Kind::Other;
+    QString channelBase;    // channels only: scheme://host/@name (or /channel/ID, /c/name, /user/name), no trailing slash
+    QString videoId;        // videos and shorts (and watch URLs that are part of a playlist)
+    QString playlistId;     // playlists
+
+    bool isChannel() const { return kind == Kind::Channel; }
+    bool isPlaylist() const { return kind == Kind::Playlist; }
+    QString channelName() const;
+};
+
+// Works out what a YouTube URL points at in one pass over its host and
+// path, no regular expressions. A watch URL with a list= is a playlist,
+// the same way the playlist browser has always treated it. Anything that
+// isn't YouTube (or youtu.be) is Other.
+class UrlClassifier {
+public:
+    static UrlInfo classify(const QString &url);
+};
+
+#endif // URLCLASSIFIER_H
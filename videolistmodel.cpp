@@ -0,0 +1,403 @@
+#include "videolistmodel.h"
+#include <algorithm>
+#include <QColor>
+
+VideoListModel::VideoListModel(QObject *parent) : QAbstractListModel(parent) {
+}
+
+int VideoListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : entries.size();
+}
+
+QVariant VideoListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+    const VideoEntry &video = entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        if (!showDates || video.date.isEmpty()) {
+            return video.title;
+        }
+        return video.title + (video.exactDate ? " (" : " (~") + video.date + ")";
+    case Qt::CheckStateRole:
+        return checked.testBit(index.row()) ? Qt::Checked : Qt::Unchecked;
+    case Qt::ForegroundRole:
+        return archivedIds.contains(video.id) ? QVariant(QColor(Qt::gray)) : QVariant();
+    case Qt::ToolTipRole:
+        return archivedIds.contains(video.id) ? QVariant("Already downloaded") : QVariant();
+    case OriginalIndexRole:
+        return index.row() + 1;
+    default:
+        return QVariant();
+    }
+}
+
+bool VideoListModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+    if (!index.isValid() || role != Qt::CheckStateRole) {
+        return false;
+    }
+    setChecked({index.row()}, value.toInt() == Qt::Checked);
+    return true;
+}
+
+Qt::ItemFlags VideoListModel::flags(const QModelIndex &index) const {
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+}
+
+void VideoListModel::appendEntries(const QVector<VideoEntry> &newEntries) {
+    if (newEntries.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), entries.size(), entries.size() + newEntries.size() - 1);
+    entries += newEntries;
+    checked.resize(entries.size());
+    for (int row = entries.size() - newEntries.size(); row < entries.size(); ++row) {
+        titles.add(entries.at(row).title);
+        if (!entries.at(row).id.isEmpty()) {
+            idRows.insert(entries.at(row).id, row);
+        }
+    }
+    endInsertRows();
+}
+
+void VideoListModel::prependEntries(const QVector<VideoEntry> &newEntries) {
+    if (newEntries.isEmpty()) {
+        return;
+    }
+    int count = newEntries.size();
+    beginInsertRows(QModelIndex(), 0, count - 1);
+    entries = newEntries + entries;
+    QBitArray shifted(entries.size());
+    for (int i = 0; i < checked.size(); ++i) {
+        if (checked.testBit(i)) {
+            shifted.setBit(i + count);
+        }
+    }
+    checked = shifted;
+    rebuildLookups();
+    endInsertRows();
+}
+
+void VideoListModel::truncate(int count) {
+    if (count < 0 || count >= entries.size()) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), count, entries.size() - 1);
+    for (int i = count; i < checked.size(); ++i) {
+        if (checked.testBit(i)) {
+            checkedCount--;
+        }
+    }
+    entries.resize(count);
+    checked.resize(count);
+    rebuildLookups();
+    endRemoveRows();
+    emit checkStateChanged();
+}
+
+void VideoListModel::rebuildLookups() {
+    titles.clear();
+    idRows.clear();
+    for (int row = 0; row < entries.size(); ++row) {
+        titles.add(entries.at(row).title);
+        if (!entries.at(row).id.isEmpty()) {
+            idRows.insert(entries.at(row).id, row);
+        }
+    }
+}
+
+void VideoListModel::clear() {
+    beginResetModel();
+    entries.clear();
+    idRows.clear();
+    checked.clear();
+    titles.clear();
+    checkedCount = 0;
+    endResetModel();
+    emit checkStateChanged();
+}
+
+const QVector<VideoEntry> &VideoListModel::entryList() const {
+    return entries;
+}
+
+void VideoListModel::setShowDates(bool show) {
+    if (show == showDates) {
+        return;
+    }
+    showDates = show;
+    if (!entries.isEmpty()) {
+        emit dataChanged(index(0), index(entries.size() - 1), {Qt::DisplayRole});
+    }
+}
+
+const VideoEntry &VideoListModel::entry(int row) const {
+    return entries.at(row);
+}
+
+int VideoListModel::entryCount() const {
+    return entries.size();
+}
+
+int VideoListModel::rowForId(const QString &id) const {
+    return idRows.value(id, -1);
+}
+
+void VideoListModel::setDate(int row, const QString &date, bool exact) {
+    if (row < 0 || row >= entries.size()) {
+        return;
+    }
+    entries[row].date = date;
+    entries[row].exactDate = exact;
+    emit dataChanged(index(row), index(row), {Qt::DisplayRole});
+}
+
+void VideoListModel::setChecked(const QVector<int> &rowsToChange, bool value) {
+    int first = -1;
+    int last = -1;
+    for (int row : rowsToChange) {
+        if (row < 0 || row >= entries.size() || checked.testBit(row) == value) {
+            continue;
+        }
+        checked.setBit(row, value);
+        checkedCount += value ? 1 : -1;
+        first = first < 0 ? row : qMin(first, row);
+        last = qMax(last, row);
+    }
+    if (first < 0) {
+        return;
+    }
+    // One range for the whole batch, the views only repaint what is visible anyway
+    emit dataChanged(index(first), index(last), {Qt::CheckStateRole});
+    emit checkStateChanged();
+}
+
+void VideoListModel::setAllChecked(bool value) {
+    if (entries.isEmpty()) {
+        return;
+    }
+    checked.fill(value);
+    checkedCount = value ? entries.size() : 0;
+    emit dataChanged(index(0), index(entries.size() - 1), {Qt::CheckStateRole});
+    emit checkStateChanged();
+}
+
+bool VideoListModel::hasChecked() const {
+    return checkedCount > 0;
+}
+
+void VideoListModel::setArchivedIds(const QSet<QString> &ids) {
+    archivedIds = ids;
+    if (!entries.isEmpty()) {
+        emit dataChanged(index(0), index(entries.size() - 1), {Qt::ForegroundRole, Qt::ToolTipRole});
+    }
+}
+
+void VideoListModel::addArchivedIds(const QStringList &ids) {
+    for (const QString &id : ids) {
+        archivedIds.insert(id);
+        int row = rowForId(id);
+        if (row >= 0) {
+            emit dataChanged(index(row), index(row), {Qt::ForegroundRole, Qt::ToolTipRole});
+        }
+    }
+}
+
+bool VideoListModel::isArchived(int row) const {
+    return row >= 0 && row < entries.size() && archivedIds.contains(entries.at(row).id);
+}
+
+const TitleIndex &VideoListModel::titleIndex() const {
+    return titles;
+}
+
+const QBitArray &VideoListModel::checkedSet() const {
+    return checked;
+}
+
+QList<int> VideoListModel::checkedIndices() const {
+    QList<int> indices;
+    indices.reserve(checkedCount);
+    for (int i = 0; i < checked.size(); ++i) {
+        if (checked.testBit(i)) {
+            indices << i + 1;
+        }
+    }
+    return indices;
+}
+
+QStringList VideoListModel::checkedUrls() const {
+    QStringList urls;
+    urls.reserve(checkedCount);
+    for (int i = 0; i < checked.size(); ++i) {
+        if (checked.testBit(i) && !entries.at(i).url.isEmpty()) {
+            urls << entries.at(i).url;
+        }
+    }
+    return urls;
+}
+
+VideoFilterModel::VideoFilterModel(VideoListModel *source, QObject *parent) : QAbstractListModel(parent), source(source) {
+    connect(source, &QAbstractItemModel::modelAboutToBeReset, this, &VideoFilterModel::onSourceAboutToBeReset);
+    connect(source, &QAbstractItemModel::modelReset, this, &VideoFilterModel::onSourceReset);
+    connect(source, &QAbstractItemModel::rowsAboutToBeInserted, this, &VideoFilterModel::onSourceRowsAboutToBeInserted);
+    connect(source, &QAbstractItemModel::rowsInserted, this, &VideoFilterModel::onSourceRowsInserted);
+    connect(source, &QAbstractItemModel::rowsAboutToBeRemoved, this, &VideoFilterModel::onSourceRowsAboutToBeRemoved);
+    connect(source, &QAbstractItemModel::rowsRemoved, this, &VideoFilterModel::onSourceRowsRemoved);
+    connect(source, &QAbstractItemModel::dataChanged, this, &VideoFilterModel::onSourceDataChanged);
+}
+
+int VideoFilterModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return isFiltering() ? rows.size() : source->rowCount();
+}
+
+QVariant VideoFilterModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    return source->data(source->index(sourceRow(index.row())), role);
+}
+
+bool VideoFilterModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+    if (!index.isValid()) {
+        return false;
+    }
+    return source->setData(source->index(sourceRow(index.row())), value, role);
+}
+
+Qt::ItemFlags VideoFilterModel::flags(const QModelIndex &index) const {
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    return source->flags(source->index(sourceRow(index.row())));
+}
+
+void VideoFilterModel::setFilterText(const QString &text) {
+    QString folded = TitleIndex::fold(text);
+    if (folded == filter) {
+        return;
+    }
+    beginResetModel();
+    if (folded.isEmpty()) {
+        rows.clear();
+    } else if (!filter.isEmpty() && folded.contains(filter)) {
+        // Typing more can only drop rows, so only recheck the current ones
+        rows = source->titleIndex().narrow(rows, folded);
+    } else {
+        rows = source->titleIndex().search(folded);
+    }
+    filter = folded;
+    endResetModel();
+}
+
+QString VideoFilterModel::filterText() const {
+    return filter;
+}
+
+bool VideoFilterModel::isFiltering() const {
+    return !filter.isEmpty();
+}
+
+int VideoFilterModel::sourceRow(int row) const {
+    return isFiltering() ? rows.value(row, -1) : row;
+}
+
+void VideoFilterModel::setVisibleChecked(bool checked) {
+    if (isFiltering()) {
+        source->setChecked(rows, checked);
+    } else {
+        source->setAllChecked(checked);
+    }
+}
+
+bool VideoFilterModel::matches(int sourceRow) const {
+    return source->titleIndex().matches(sourceRow, filter);
+}
+
+void VideoFilterModel::onSourceAboutToBeReset() {
+    beginResetModel();
+}
+
+void VideoFilterModel::onSourceReset() {
+    rows.clear();
+    if (isFiltering()) {
+        rows = source->titleIndex().search(filter);
+    }
+    endResetModel();
+}
+
+void VideoFilterModel::onSourceRowsAboutToBeInserted(const QModelIndex &, int first, int last) {
+    if (!isFiltering()) {
+        beginInsertRows(QModelIndex(), first, last);
+    } else if (first < source->rowCount()) {
+        resetting = true;
+        beginResetModel();
+    }
+}
+
+void VideoFilterModel::onSourceRowsInserted(const QModelIndex &, int first, int last) {
+    if (!isFiltering()) {
+        endInsertRows();
+        return;
+    }
+    if (resetting) {
+        endRowMapReset();
+        return;
+    }
+    QVector<int> matched;
+    for (int i = first; i <= last; ++i) {
+        if (matches(i)) {
+            matched.append(i);
+        }
+    }
+    if (matched.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), rows.size(), rows.size() + matched.size() - 1);
+    rows += matched;
+    endInsertRows();
+}
+
+void VideoFilterModel::onSourceRowsAboutToBeRemoved(const QModelIndex &, int first, int last) {
+    if (!isFiltering()) {
+        beginRemoveRows(QModelIndex(), first, last);
+    } else {
+        resetting = true;
+        beginResetModel();
+    }
+}
+
+void VideoFilterModel::onSourceRowsRemoved() {
+    if (!resetting) {
+        endRemoveRows();
+        return;
+    }
+    endRowMapReset();
+}
+
+void VideoFilterModel::endRowMapReset() {
+    resetting = false;
+    rows = source->titleIndex().search(filter);
+    endResetModel();
+}
+
+void VideoFilterModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles) {
+    if (!isFiltering()) {
+        emit dataChanged(index(topLeft.row()), index(bottomRight.row()), roles);
+        return;
+    }
+    // rows is ascending, so the changed source range maps to one contiguous proxy range
+    auto firstIt = std::lower_bound(rows.cbegin(), rows.cend(), topLeft.row());
+    auto lastIt = std::upper_bound(firstIt, rows.cend(), bottomRight.row());
+    if (firstIt == lastIt) {
+        return;
+    }
+    emit dataChanged(index(firstIt - rows.cbegin()), index(lastIt - rows.cbegin() - 1), roles);
+}
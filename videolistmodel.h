@@ -0,0 +1,114 @@
+#ifndef VIDEOLISTMODEL_H
+#define VIDEOLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QBitArray>
+#include <QHash>
+#include <QSet>
+#include "titleindex.h"
+
+struct VideoEntry {
+    QString title;
+    QString date;
+    QString id;
+    QString url;
+    qint32 duration = -1;
+    // date came from the full video page, not the approximate listing one
+    bool exactDate = false;
+};
+
+// Playlist/channel listing stored as one contiguous vector of entries.
+// Rows are the original listing order, OriginalIndexRole is the 1-based
+// position yt-dlp expects in --playlist-items. Check state lives in a
+// bitset indexed the same way, so filtering never touches it. Videos whose
+// id is in the archived set are drawn greyed out.
+class VideoListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles { OriginalIndexRole = Qt::UserRole + 1 };
+
+    explicit VideoListModel(QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    void appendEntries(const QVector<VideoEntry> &newEntries);
+    void prependEntries(const QVector<VideoEntry> &newEntries);
+    void truncate(int count);
+    void clear();
+    const QVector<VideoEntry> &entryList() const;
+    void setShowDates(bool show);
+    const VideoEntry &entry(int row) const;
+    int entryCount() const;
+    int rowForId(const QString &id) const;
+    void setDate(int row, const QString &date, bool exact);
+    void setChecked(const QVector<int> &rows, bool value);
+    void setAllChecked(bool value);
+    bool hasChecked() const;
+    const TitleIndex &titleIndex() const;
+    const QBitArray &checkedSet() const;
+    QList<int> checkedIndices() const;
+    QStringList checkedUrls() const;
+    void setArchivedIds(const QSet<QString> &ids);
+    void addArchivedIds(const QStringList &ids);
+    bool isArchived(int row) const;
+
+signals:
+    void checkStateChanged();
+
+private:
+    void rebuildLookups();
+
+    QVector<VideoEntry> entries;
+    QHash<QString, int> idRows;
+    QBitArray checked;
+    int checkedCount = 0;
+    TitleIndex titles;
+    QSet<QString> archivedIds;
+    bool showDates = true;
+};
+
+// Exposes only the rows of a VideoListModel whose title contains the filter
+// text, looked up in the source's TitleIndex. With no filter it passes rows
+// straight through without a row map.
+class VideoFilterModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit VideoFilterModel(VideoListModel *source, QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    void setFilterText(const QString &text);
+    QString filterText() const;
+    bool isFiltering() const;
+    int sourceRow(int row) const;
+    void setVisibleChecked(bool checked);
+
+private:
+    bool matches(int sourceRow) const;
+    void onSourceAboutToBeReset();
+    void onSourceReset();
+    void onSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved();
+    void endRowMapReset();
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+
+    VideoListModel *source;
+    QString filter;
+    QVector<int> rows;
+    // Inserts other than appends and removals just rebuild the row map
+    bool resetting = false;
+};
+
+#endif // VIDEOLISTMODEL_H
@@ -0,0 +1,297 @@
+#include "workerpool.h"
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTimer>
+#include "processreaper.h"
+
+WorkerPool::WorkerPool(QObject *parent) : QObject(parent) {
+}
+
+WorkerPool::~WorkerPool() {
+    for (Worker *worker : std::as_const(workers)) {
+        ProcessReaper::stop(worker->process);
+        delete worker;
+    }
+}
+
+QString WorkerPool::scriptPath() {
+    // python can't read from the resources, so the script is copied out (again whenever it changed)
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/ytdlpfrontend";
+    QDir().mkpath(dir);
+    QString path = dir + "/ytdlpworker.py";
+    QFile resource(":/ytdlpworker.py");
+    if (!resource.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    QByteArray script = resource.readAll();
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly) && file.readAll() == script) {
+        return path;
+    }
+    file.close();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(script) != script.size()) {
+        return QString();
+    }
+    return path;
+}
+
+void WorkerPool::setEnabled(bool enable) {
+    enabled = enable;
+    if (enabled) {
+        // Trying again after a failure is up to the user, maybe they installed something meanwhile
+        failed = false;
+        return;
+    }
+    // Running jobs finish in their workers, waiting ones go back to the caller
+    const QList<Worker*> current = workers;
+    for (Worker *worker : current) {
+        if (!worker->ticket) {
+            retire(worker);
+        }
+    }
+    rejectPending("Python workers were turned off");
+}
+
+bool WorkerPool::isEnabled() const {
+    return enabled;
+}
+
+bool WorkerPool::isUsable() const {
+    return enabled && !failed;
+}
+
+void WorkerPool::warmUp() {
+    if (isUsable() && workers.isEmpty()) {
+        spawn();
+    }
+}
+
+int WorkerPool::run(const QStringList &args) {
+    int ticket = nextTicket++;
+    pending.append(qMakePair(ticket, args));
+    dispatch();
+    return ticket;
+}
+
+void WorkerPool::cancel(int ticket) {
+    for (int i = 0; i < pending.size(); ++i) {
+        if (pending.at(i).first == ticket) {
+            pending.removeAt(i);
+            finishLater(ticket, -1, QProcess::CrashExit);
+            return;
+        }
+    }
+    for (Worker *worker : std::as_const(workers)) {
+        if (worker->ticket == ticket) {
+            // yt_dlp can't be interrupted from outside, the worker goes and a new one takes its place
+            worker->ticket = 0;
+            retire(worker);
+            finishLater(ticket, -1, QProcess::CrashExit);
+            dispatch();
+            return;
+        }
+    }
+}
+
+void WorkerPool::setMaxWorkers(int count) {
+    workerLimit = qMax(1, count);
+    const QList<Worker*> current = workers;
+    for (Worker *worker : current) {
+        if (workers.size() <= workerLimit) {
+            break;
+        }
+        if (!worker->ticket) {
+            retire(worker);
+        }
+    }
+    dispatch();
+}
+
+int WorkerPool::maxWorkers() const {
+    return workerLimit;
+}
+
+WorkerPool::Worker *WorkerPool::findWorker(QProcess *process) const {
+    for (Worker *worker : workers) {
+        if (worker->process == process) {
+            return worker;
+        }
+    }
+    return nullptr;
+}
+
+void WorkerPool::spawn() {
+    QString script = scriptPath();
+    if (script.isEmpty()) {
+        fail("Couldn't write the worker script to the cache directory");
+        return;
+    }
+    Worker *worker = new Worker;
+    worker->process = new QProcess(this);
+    QProcess *process = worker->process;
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("PYTHONIOENCODING", "utf-8");
+    process->setProcessEnvironment(environment);
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, process]() {
+        onWorkerOutput(process);
+    });
+    connect(process, &QProcess::readyReadStandardError, this, [this, process]() {
+        onWorkerErrorOutput(process);
+    });
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process]() {
+        onWorkerExited(process);
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            onWorkerExited(process);
+        }
+    });
+    workers.append(worker);
+    process->start("python3", QStringList() << "-u" << script);
+}
+
+void WorkerPool::dispatch() {
+    if (!isUsable()) {
+        return;
+    }
+    int starting = 0;
+    for (Worker *worker : std::as_const(workers)) {
+        if (!worker->ready) {
+            starting++;
+        } else if (!worker->ticket && !pending.isEmpty()) {
+            QPair<int, QStringList> job = pending.takeFirst();
+            QJsonObject request;
+            request.insert("id", job.first);
+            request.insert("args", QJsonArray::fromStringList(job.second));
+            worker->ticket = job.first;
+            worker->jobs++;
+            worker->process->write(QJsonDocument(request).toJson(QJsonDocument::Compact) + "\n");
+        }
+    }
+    while (workers.size() < workerLimit && pending.size() > starting) {
+        spawn();
+        starting++;
+    }
+}
+
+void WorkerPool::retire(Worker *worker) {
+    workers.removeOne(worker);
+    ProcessReaper::stop(worker->process);
+    delete worker;
+}
+
+void WorkerPool::onWorkerOutput(QProcess *process) {
+    Worker *worker = findWorker(process);
+    if (!worker) {
+        return;
+    }
+    worker->buffer += process->readAllStandardOutput();
+    int newline;
+    while ((newline = worker->buffer.indexOf('\n')) >= 0) {
+        QByteArray line = worker->buffer.left(newline);
+        worker->buffer.remove(0, newline + 1);
+        QJsonObject message = QJsonDocument::fromJson(line).object();
+        QString type = message.value("type").toString();
+        int ticket = message.value("id").toInt();
+        if (type == "ready") {
+            worker->ready = true;
+            dispatch();
+        } else if (type == "fatal") {
+            fail(message.value("error").toString());
+            return;
+        } else if (ticket != worker->ticket) {
+            // Left over from a cancelled job
+            continue;
+        } else if (type == "out" || type == "err") {
+            emit output(ticket, message.value("data").toString().toUtf8(), type == "err");
+        } else if (type == "exit") {
+            worker->ticket = 0;
+            if (worker->jobs >= MaxJobsPerWorker || !enabled) {
+                retire(worker);
+                worker = nullptr;
+            }
+            emit finished(ticket, message.value("code").toInt(), QProcess::NormalExit);
+            dispatch();
+            if (!worker) {
+                return;
+            }
+        }
+        // Whatever a handler did, the worker may be gone by now
+        if (!findWorker(process)) {
+            return;
+        }
+    }
+}
+
+void WorkerPool::onWorkerErrorOutput(QProcess *process) {
+    Worker *worker = findWorker(process);
+    if (!worker) {
+        return;
+    }
+    // yt-dlp's own messages come through stdout, this is python itself or a tool like ffmpeg
+    QByteArray data = process->readAllStandardError();
+    if (worker->ticket) {
+        emit output(worker->ticket, data, true);
+    } else if (!worker->ready) {
+        worker->startupErrors += data;
+    }
+}
+
+void WorkerPool::onWorkerExited(QProcess *process) {
+    Worker *worker = findWorker(process);
+    if (!worker) {
+        return;
+    }
+    workers.removeOne(worker);
+    int ticket = worker->ticket;
+    bool ready = worker->ready;
+    QString reason = process->error() == QProcess::FailedToStart ? "Couldn't start python3: " + process->errorString()
+                                                                   : QString::fromUtf8(worker->startupErrors).trimmed();
+    process->deleteLater();
+    delete worker;
+    if (!ready) {
+        fail(reason.isEmpty() ? "The python worker quit while starting" : reason);
+        return;
+    }
+    if (ticket) {
+        emit output(ticket, "Python worker quit unexpectedly\n", true);
+        emit finished(ticket, -1, QProcess::CrashExit);
+    }
+    dispatch();
+}
+
+void WorkerPool::fail(const QString &reason) {
+    if (failed) {
+        return;
+    }
+    failed = true;
+    const QList<Worker*> current = workers;
+    for (Worker *worker : current) {
+        if (!worker->ready) {
+            retire(worker);
+        }
+    }
+    emit unavailable(reason);
+    rejectPending(reason);
+}
+
+void WorkerPool::rejectPending(const QString &reason) {
+    const QList<QPair<int, QStringList>> waiting = pending;
+    pending.clear();
+    // From the event loop, this can happen inside run() before the caller has its ticket
+    QTimer::singleShot(0, this, [this, waiting, reason]() {
+        for (const QPair<int, QStringList> &job : waiting) {
+            emit failedToStart(job.first, reason);
+        }
+    });
+}
+
+void WorkerPool::finishLater(int ticket, int exitCode, QProcess::ExitStatus exitStatus) {
+    QTimer::singleShot(0, this, [this, ticket, exitCode, exitStatus]() {
+        emit finished(ticket, exitCode, exitStatus);
+    });
+}
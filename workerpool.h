@@ -0,0 +1,79 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <QObject>
+#include <QProcess>
+#include <QByteArray>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+
+// Long-lived python processes running the bundled ytdlpworker.py, which
+// imports yt_dlp once and then runs one job after another, so a job skips
+// python's startup and the extractor imports. Jobs take the same arguments
+// as the yt-dlp command line. At most maxWorkers() workers run, idle ones
+// wait for the next job and are replaced after MaxJobsPerWorker jobs.
+// If a worker can't come up (no python3, or yt-dlp isn't installed as a
+// python module) the pool turns itself off and waiting jobs get
+// failedToStart(), so the caller can run yt-dlp directly instead.
+class WorkerPool : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int MaxJobsPerWorker = 25;
+
+    explicit WorkerPool(QObject *parent = nullptr);
+    ~WorkerPool();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    // Enabled and no worker has failed to start so far
+    bool isUsable() const;
+    // Starts a worker ahead of time, so the first job doesn't wait for the imports
+    void warmUp();
+
+    // Returns a ticket the signals refer to
+    int run(const QStringList &args);
+    // finished() still comes, from the event loop
+    void cancel(int ticket);
+
+    void setMaxWorkers(int count);
+    int maxWorkers() const;
+
+signals:
+    void output(int ticket, const QByteArray &data, bool isError);
+    void finished(int ticket, int exitCode, QProcess::ExitStatus exitStatus);
+    void failedToStart(int ticket, const QString &reason);
+    void unavailable(const QString &reason);
+
+private:
+    struct Worker {
+        QProcess *process = nullptr;
+        bool ready = false;
+        int ticket = 0;
+        int jobs = 0;
+        QByteArray buffer;
+        QByteArray startupErrors;
+    };
+
+    static QString scriptPath();
+    Worker *findWorker(QProcess *process) const;
+    void spawn();
+    void dispatch();
+    void retire(Worker *worker);
+    void onWorkerOutput(QProcess *process);
+    void onWorkerErrorOutput(QProcess *process);
+    void onWorkerExited(QProcess *process);
+    void fail(const QString &reason);
+    void rejectPending(const QString &reason);
+    void finishLater(int ticket, int exitCode, QProcess::ExitStatus exitStatus);
+
+    QList<Worker*> workers;
+    QList<QPair<int, QStringList>> pending;
+    int nextTicket = 1;
+    int workerLimit = 2;
+    bool enabled = false;
+    bool failed = false;
+};
+
+#endif // WORKERPOOL_H
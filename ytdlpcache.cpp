@@ -0,0 +1,93 @@
+#include "ytdlpcache.h"
+#include <QStandardPaths>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QDateTime>
+#include <QList>
+#include <algorithm>
+
+static QString baseDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/ytdlpfrontend";
+}
+
+static QFileInfoList cacheFiles() {
+    QFileInfoList files;
+    QDirIterator it(YtdlpCache::directory(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        files.append(it.fileInfo());
+    }
+    return files;
+}
+
+QString YtdlpCache::directory() {
+    static const QString dir = []() {
+        QString path = baseDirectory() + "/yt-dlp";
+        QDir().mkpath(path);
+        return path;
+    }();
+    return dir;
+}
+
+QStringList YtdlpCache::args() {
+    static const QStringList cacheArgs = {"--cache-dir", directory()};
+    return cacheArgs;
+}
+
+qint64 YtdlpCache::size() {
+    qint64 total = 0;
+    for (const QFileInfo &file : cacheFiles()) {
+        total += file.size();
+    }
+    return total;
+}
+
+qint64 YtdlpCache::evict(qint64 maxBytes) {
+    // Outside the cache directory, so it's never counted or evicted itself
+    QDir().mkpath(baseDirectory());
+    QLockFile lock(baseDirectory() + "/yt-dlp-cache.lock");
+    if (!lock.tryLock(0)) {
+        return -1;
+    }
+    QFileInfoList files = cacheFiles();
+    qint64 total = 0;
+    for (const QFileInfo &file : std::as_const(files)) {
+        total += file.size();
+    }
+    if (total <= maxBytes) {
+        return 0;
+    }
+    std::sort(files.begin(), files.end(), [](const QFileInfo &a, const QFileInfo &b) {
+        return a.lastModified() < b.lastModified();
+    });
+    // Down to three quarters, so it isn't evicting again after every download
+    qint64 target = maxBytes / 4 * 3;
+    qint64 freed = 0;
+    for (const QFileInfo &file : std::as_const(files)) {
+        if (total - freed <= target) {
+            break;
+        }
+        if (QFile::remove(file.filePath())) {
+            freed += file.size();
+        }
+    }
+    return freed;
+}
+
+bool YtdlpCache::needsWarmUp() {
+    QDateTime newest;
+    for (const QFileInfo &file : cacheFiles()) {
+        if (!newest.isValid() || file.lastModified() > newest) {
+            newest = file.lastModified();
+        }
+    }
+    return !newest.isValid() || newest.secsTo(QDateTime::currentDateTime()) > WarmUpAgeSecs;
+}
+
+QStringList YtdlpCache::warmUpArgs() {
+    // "Me at the zoo", 19 seconds and not going anywhere
+    return QStringList() << "--simulate" << "--quiet" << "--no-warnings" << "--no-playlist" << "https://www.youtube.com/watch?v=jNQXAC9IVRw";
+}
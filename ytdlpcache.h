@@ -0,0 +1,32 @@
+#ifndef YTDLPCACHE_H
+#define YTDLPCACHE_H
+
+#include <QString>
+#include <QStringList>
+
+// The --cache-dir shared by every yt-dlp the app starts (downloaded player
+// JS, solved signature functions), kept under the cache location instead
+// of yt-dlp's default so it can be bounded to MaxBytes. yt-dlp replaces
+// cache files atomically and reads them in one go, so evicting while
+// downloads run only costs a cache miss; the lock file keeps two
+// instances (the window and a headless cron run) from evicting at once.
+class YtdlpCache {
+public:
+    static constexpr qint64 MaxBytes = 64 * 1024 * 1024;
+    // A cache nothing was written to for this long is considered cold
+    static constexpr int WarmUpAgeSecs = 24 * 60 * 60;
+
+    static QString directory();
+    // Put in front of every yt-dlp command line
+    static QStringList args();
+    static qint64 size();
+    // Deletes the least recently written files until the cache is down to
+    // three quarters of maxBytes. Returns the bytes freed, or -1 when
+    // another instance is evicting right now.
+    static qint64 evict(qint64 maxBytes = MaxBytes);
+    static bool needsWarmUp();
+    // Simulates one short video, which fetches the current player and caches its solved signatures
+    static QStringList warmUpArgs();
+};
+
+#endif // YTDLPCACHE_H
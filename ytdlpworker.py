@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# Long-lived yt-dlp worker for YTDLPFrontend (see workerpool.h).
+# Imports yt_dlp once, then runs one job after another from JSON lines on stdin:
+#   {"id": 1, "args": ["--ignore-config", "-f", "best", "https://..."]}
+# and answers with JSON lines on stdout:
+#   {"type": "ready", "version": "..."}
+#   {"id": 1, "type": "out", "data": "..."}     what yt-dlp printed, progress lines included
+#   {"id": 1, "type": "err", "data": "..."}
+#   {"id": 1, "type": "exit", "code": 0}
+# or {"type": "fatal", "error": "..."} when yt_dlp can't be imported.
+import json
+import os
+import sys
+import threading
+import traceback
+
+# Keep the real stdout for messages only. fd 1 goes to stderr, so anything
+# ffmpeg or aria2c print there can't end up in the middle of a message
+protocol = os.fdopen(os.dup(1), "w", encoding="utf-8", buffering=1)
+os.dup2(2, 1)
+# With -N, fragment threads report progress at the same time as the main one
+protocol_lock = threading.Lock()
+
+
+def send(message):
+    line = json.dumps(message) + "\n"
+    with protocol_lock:
+        protocol.write(line)
+        protocol.flush()
+
+
+try:
+    import yt_dlp
+    from yt_dlp.utils import DownloadError, expand_path
+except Exception as e:
+    send({"type": "fatal", "error": "Couldn't import yt_dlp: %s" % e})
+    sys.exit(1)
+
+
+class Forward:
+    """Hands everything yt-dlp writes to the frontend, tagged with the job."""
+
+    encoding = "utf-8"
+
+    def __init__(self, job_id, stream):
+        self.job_id = job_id
+        self.stream = stream
+
+    def write(self, text):
+        if text:
+            send({"id": self.job_id, "type": self.stream, "data": text})
+        return len(text)
+
+    def flush(self):
+        pass
+
+    def isatty(self):
+        return False
+
+
+def download(args):
+    # Same path yt-dlp's own main() takes for a download
+    parsed = yt_dlp.parse_options(args)
+    with yt_dlp.YoutubeDL(parsed.ydl_opts) as ydl:
+        if parsed.options.load_info_filename is not None:
+            return ydl.download_with_info_file(expand_path(parsed.options.load_info_filename))
+        return ydl.download(parsed.urls)
+
+
+def run(job_id, args):
+    saved = sys.stdout, sys.stderr
+    sys.stdout, sys.stderr = Forward(job_id, "out"), Forward(job_id, "err")
+    try:
+        code = download(args)
+    except SystemExit as e:
+        # Bad options end up in parser.error(), which exits
+        if isinstance(e.code, int) or e.code is None:
+            code = e.code or 0
+        else:
+            sys.stderr.write("%s\n" % e.code)
+            code = 2
+    except DownloadError:
+        # yt-dlp already printed the error
+        code = 1
+    except Exception:
+        traceback.print_exc()
+        code = 1
+    finally:
+        sys.stdout, sys.stderr = saved
+    send({"id": job_id, "type": "exit", "code": code})
+
+
+def main():
+    send({"type": "ready", "version": yt_dlp.version.__version__})
+    for line in sys.stdin:
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            request = json.loads(line)
+        except ValueError:
+            continue
+        run(request.get("id"), [str(arg) for arg in request.get("args", [])])
+
+
+if __name__ == "__main__":
+    main()